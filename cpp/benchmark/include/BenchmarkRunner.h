@@ -9,6 +9,8 @@
 #include "BenchmarkConfig.h"
 #include "Statistics.h"
 #include "CsvExporter.h"
+#include "Profiler.h"
+#include "ResultStore.h"
 
 namespace benchmark {
 
@@ -57,6 +59,10 @@ private:
     int main(int argc, char* argv[]) { \
         size_t iterations = 100000; \
         std::string test_run = ""; \
+        std::string store_path = ""; \
+        std::string run_id = ""; \
+        int profile_hz = 0; \
+        long memory_interval_ms = 10; \
         benchmark::CsvExporter::TimeUnit time_unit = benchmark::CsvExporter::NANOSECONDS; \
         for (int i = 1; i < argc; ++i) { \
             std::string arg = argv[i]; \
@@ -64,6 +70,14 @@ private:
                 iterations = std::stoul(argv[++i]); \
             } else if (arg == "--testrun" && i + 1 < argc) { \
                 test_run = "_" + std::string(argv[++i]); \
+            } else if (arg == "--store" && i + 1 < argc) { \
+                store_path = argv[++i]; \
+            } else if (arg == "--run-id" && i + 1 < argc) { \
+                run_id = argv[++i]; \
+            } else if (arg == "--memory-interval" && i + 1 < argc) { \
+                memory_interval_ms = std::stol(argv[++i]); \
+            } else if (arg == "--profile" && i + 1 < argc) { \
+                profile_hz = std::stoi(argv[++i]); \
             } else if (arg == "--unit" && i + 1 < argc) { \
                 std::string unit_str = argv[++i]; \
                 if (unit_str == "ns") { \
@@ -86,17 +100,51 @@ private:
             const std::string& name = pair.first; \
             const benchmark::BenchmarkFunction& func = pair.second; \
             std::cout << "Running benchmark: " << name << "...\n"; \
-            func(config, operation_stats[name]); \
+            benchmark::MemoryTracker memory_tracker{std::chrono::milliseconds(memory_interval_ms)}; \
+            if (memory_interval_ms >= 0) { \
+                memory_tracker.start(); \
+            } \
+            if (profile_hz > 0) { \
+                benchmark::SamplingProfiler profiler(profile_hz); \
+                bool profiling = profiler.start(); \
+                func(config, operation_stats[name]); \
+                profiler.stop(); \
+                std::string profile_path = std::string("results/") + project_name + "_" + name + "_profile" + test_run + ".folded"; \
+                if (profiling && profiler.writeFolded(profile_path)) { \
+                    std::cout << "Wrote " << profiler.sampleCount() << " samples (" << profiler.droppedCount() \
+                              << " dropped) to " << profile_path << "\n"; \
+                } else { \
+                    std::cerr << "Failed to profile benchmark " << name << ".\n"; \
+                } \
+            } else { \
+                func(config, operation_stats[name]); \
+            } \
+            if (memory_interval_ms >= 0) { \
+                operation_stats[name].setMemoryUsage(memory_tracker.stop()); \
+            } \
         } \
         std::cout << "Exporting results to CSV...\n"; \
         benchmark::CsvExporter exporter(project_name, test_run, time_unit); \
         bool export_success = exporter.exportAllToCsv(operation_stats); \
         if (export_success) { \
-            std::cout << "Results exported successfully to " << project_name << "_raw" << test_run << ".csv and " \
-                      << project_name << "_stats" << test_run << ".csv\n"; \
+            std::cout << "Results exported successfully to " << project_name << "_raw" << test_run << ".csv, " \
+                      << project_name << "_stats" << test_run << ".csv, " \
+                      << project_name << "_hist" << test_run << ".csv and " \
+                      << project_name << "_percentiles" << test_run << ".csv\n"; \
         } else { \
             std::cerr << "Failed to export results to CSV.\n"; \
         } \
+        if (!store_path.empty()) { \
+            if (run_id.empty() && !test_run.empty()) { \
+                run_id = test_run.substr(1); \
+            } \
+            benchmark::RunInfo run = benchmark::RunInfo::current(run_id); \
+            if (benchmark::ResultStore(store_path).append(run, operation_stats)) { \
+                std::cout << "Appended run " << run.run_id << " (" << run.git_revision << "@" << run.host << ") to " << store_path << "\n"; \
+            } else { \
+                std::cerr << "Failed to append results to store " << store_path << ".\n"; \
+            } \
+        } \
         return 0; \
     }
 
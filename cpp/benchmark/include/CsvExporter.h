@@ -7,6 +7,8 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include "Histogram.h"
 #include "Statistics.h"
 
 namespace benchmark {
@@ -85,7 +87,17 @@ public:
 
         // Write header for statistics
         std::string unit_label = this->getUnitLabel();
-        ofs << "Operation,Mean (" << unit_label << "),Median (" << unit_label << "),P90 (" << unit_label << "),Standard Deviation (" << unit_label << "),Count\n";
+        // Memory columns are only present when at least one benchmark was tracked
+        bool with_memory = false;
+        for (const auto& pair : operation_stats) {
+            with_memory = with_memory || pair.second.memoryUsage().tracked;
+        }
+
+        ofs << "Operation,Mean (" << unit_label << "),Median (" << unit_label << "),P90 (" << unit_label << "),Standard Deviation (" << unit_label << "),Count";
+        if (with_memory) {
+            ofs << ",RSS Start (KB),RSS End (KB),RSS Peak (KB),Minor Faults,Major Faults";
+        }
+        ofs << "\n";
 
         int operation_count = 0;
         for (const auto& pair : operation_stats) {
@@ -96,7 +108,13 @@ public:
                 << this->convertToUnit(stats.median()) << ","
                 << this->convertToUnit(stats.p90()) << ","
                 << this->convertToUnit(stats.standardDeviation()) << ","
-                << stats.count() << "\n";
+                << stats.count();
+            if (with_memory) {
+                const MemoryUsage& memory = stats.memoryUsage();
+                ofs << "," << memory.rss_start_kb << "," << memory.rss_end_kb << "," << memory.rss_peak_kb
+                    << "," << memory.minor_faults << "," << memory.major_faults;
+            }
+            ofs << "\n";
             operation_count++;
         }
 
@@ -104,14 +122,153 @@ public:
         return true;
     }
 
-    // Convenience method to export both raw data and statistics
+    // Export statistics estimated from histograms, in the same format as exportStatsToCsv
+    bool exportStatsToCsv(const std::map<std::string, Histogram>& operation_histograms) const {
+        std::string filename = this->project_name_ + "_stats" + this->test_run_ + ".csv";
+        std::string filepath = this->output_dir_ + filename;
+
+        std::ofstream ofs(filepath);
+        if (!ofs.is_open()) {
+            return false; // Failed to open file
+        }
+
+        ofs << std::fixed << std::setprecision(this->getPrecision());
+
+        std::string unit_label = this->getUnitLabel();
+        ofs << "Operation,Mean (" << unit_label << "),Median (" << unit_label << "),P90 (" << unit_label << "),Standard Deviation (" << unit_label << "),Count\n";
+
+        for (const auto& pair : operation_histograms) {
+            const Histogram& histogram = pair.second;
+            ofs << pair.first << ","
+                << this->convertToUnit(histogram.mean()) << ","
+                << this->convertToUnit(histogram.percentile(50.0)) << ","
+                << this->convertToUnit(histogram.percentile(90.0)) << ","
+                << this->convertToUnit(histogram.standardDeviation()) << ","
+                << histogram.count() << "\n";
+        }
+
+        ofs.close();
+        return true;
+    }
+
+    // Export the log-bucketed histogram of each operation; the cumulative column plots directly as a CDF
+    bool exportHistogramToCsv(const std::map<std::string, Histogram>& operation_histograms) const {
+        // Construct filename as PROJECTNAME_hist_TESTRUN.csv
+        std::string filename = this->project_name_ + "_hist" + this->test_run_ + ".csv";
+        std::string filepath = this->output_dir_ + filename;
+
+        std::ofstream ofs(filepath);
+        if (!ofs.is_open()) {
+            return false; // Failed to open file
+        }
+
+        ofs << std::fixed << std::setprecision(this->getPrecision());
+
+        // Write header for the histogram, one row per non-empty bucket
+        std::string unit_label = this->getUnitLabel();
+        ofs << "Operation,Bucket Lower (" << unit_label << "),Bucket Upper (" << unit_label << "),Count,Cumulative (%)\n";
+
+        for (const auto& pair : operation_histograms) {
+            const std::string& operation = pair.first;
+            const Histogram& histogram = pair.second;
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < histogram.bucketCount(); ++i) {
+                uint64_t count = histogram.bucketValue(i);
+                if (count == 0) continue;
+                cumulative += count;
+                ofs << operation << ","
+                    << this->convertToUnit(static_cast<long long>(Histogram::bucketLower(i))) << ","
+                    << this->convertToUnit(static_cast<long long>(Histogram::bucketUpper(i))) << ","
+                    << count << ","
+                    << std::setprecision(6) << 100.0 * static_cast<double>(cumulative) / static_cast<double>(histogram.count())
+                    << std::setprecision(this->getPrecision()) << "\n";
+            }
+        }
+
+        ofs.close();
+        return true;
+    }
+
+    // Export the percentile spectrum (P0 to P99.9999) of each operation
+    bool exportPercentilesToCsv(const std::map<std::string, Statistics>& operation_stats) const {
+        std::map<std::string, std::vector<long long>> spectrum;
+        for (const auto& pair : operation_stats) {
+            spectrum[pair.first] = pair.second.percentiles(percentileSpectrum());
+        }
+        return this->writePercentiles(spectrum);
+    }
+
+    // Export the percentile spectrum of each operation as estimated from its histogram
+    bool exportPercentilesToCsv(const std::map<std::string, Histogram>& operation_histograms) const {
+        std::map<std::string, std::vector<long long>> spectrum;
+        for (const auto& pair : operation_histograms) {
+            std::vector<long long>& values = spectrum[pair.first];
+            for (double percent : percentileSpectrum()) {
+                values.push_back(pair.second.percentile(percent));
+            }
+        }
+        return this->writePercentiles(spectrum);
+    }
+
+    // Export histogram and percentile spectrum without the raw samples
+    bool exportDistributionToCsv(const std::map<std::string, Statistics>& operation_stats) const {
+        std::map<std::string, Histogram> operation_histograms;
+        for (const auto& pair : operation_stats) {
+            operation_histograms[pair.first] = pair.second.toHistogram();
+        }
+        bool hist_success = this->exportHistogramToCsv(operation_histograms);
+        bool percentile_success = this->exportPercentilesToCsv(operation_stats);
+        return hist_success && percentile_success;
+    }
+
+    // Convenience method to export raw data, statistics and the latency distribution
     bool exportAllToCsv(const std::map<std::string, Statistics>& operation_stats) const {
         bool raw_success = this->exportRawDataToCsv(operation_stats);
         bool stats_success = this->exportStatsToCsv(operation_stats);
-        return raw_success && stats_success;
+        bool dist_success = this->exportDistributionToCsv(operation_stats);
+        return raw_success && stats_success && dist_success;
+    }
+
+    // Percentiles written by exportPercentilesToCsv
+    static const std::vector<double>& percentileSpectrum() {
+        static const std::vector<double> spectrum = {0.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 99.999, 99.9999, 100.0};
+        return spectrum;
     }
 
 private:
+    bool writePercentiles(const std::map<std::string, std::vector<long long>>& spectrum) const {
+        // Construct filename as PROJECTNAME_percentiles_TESTRUN.csv
+        std::string filename = this->project_name_ + "_percentiles" + this->test_run_ + ".csv";
+        std::string filepath = this->output_dir_ + filename;
+
+        std::ofstream ofs(filepath);
+        if (!ofs.is_open()) {
+            return false; // Failed to open file
+        }
+
+        // Write header with one column per percentile, e.g. P99.99 (ns)
+        std::string unit_label = this->getUnitLabel();
+        ofs << "Operation";
+        for (double percent : percentileSpectrum()) {
+            std::ostringstream label;
+            label << percent;
+            ofs << ",P" << label.str() << " (" << unit_label << ")";
+        }
+        ofs << "\n";
+
+        ofs << std::fixed << std::setprecision(this->getPrecision());
+        for (const auto& pair : spectrum) {
+            ofs << pair.first;
+            for (long long value : pair.second) {
+                ofs << "," << this->convertToUnit(value);
+            }
+            ofs << "\n";
+        }
+
+        ofs.close();
+        return true;
+    }
+
     std::string getUnitLabel() const {
         switch (this->time_unit_) {
             case NANOSECONDS: return "ns";
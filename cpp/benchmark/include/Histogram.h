@@ -0,0 +1,199 @@
+#ifndef BENCHMARK_LIB_HISTOGRAM_H
+#define BENCHMARK_LIB_HISTOGRAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+// Log-linear latency histogram. Values below 2^SUB_BUCKET_BITS get one bucket each; above that
+// every power of two is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so a bucket never spans
+// more than 1/128 (~0.8%) of its value. Histograms with the same layout merge by adding counts,
+// which makes them suitable for combining runs and threads without keeping raw samples.
+class Histogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 8;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+
+    Histogram() : total_(0), min_(std::numeric_limits<long long>::max()), max_(0), sum_(0.0), sum_squares_(0.0) {}
+
+    // Record a value (negative values are clamped to zero)
+    void record(long long value, uint64_t count = 1) {
+        if (count == 0) return;
+        if (value < 0) value = 0;
+        size_t index = bucketIndex(static_cast<uint64_t>(value));
+        if (index >= this->counts_.size()) {
+            this->counts_.resize(index + 1, 0);
+        }
+        this->counts_[index] += count;
+        this->total_ += count;
+        this->min_ = std::min(this->min_, value);
+        this->max_ = std::max(this->max_, value);
+        this->sum_ += static_cast<double>(value) * static_cast<double>(count);
+        this->sum_squares_ += static_cast<double>(value) * static_cast<double>(value) * static_cast<double>(count);
+    }
+
+    // Add the counts of another histogram
+    void merge(const Histogram& other) {
+        if (other.total_ == 0) return;
+        if (other.counts_.size() > this->counts_.size()) {
+            this->counts_.resize(other.counts_.size(), 0);
+        }
+        for (size_t i = 0; i < other.counts_.size(); ++i) {
+            this->counts_[i] += other.counts_[i];
+        }
+        this->total_ += other.total_;
+        this->min_ = std::min(this->min_, other.min_);
+        this->max_ = std::max(this->max_, other.max_);
+        this->sum_ += other.sum_;
+        this->sum_squares_ += other.sum_squares_;
+    }
+
+    uint64_t count() const {
+        return this->total_;
+    }
+
+    long long min() const {
+        return this->total_ == 0 ? 0 : this->min_;
+    }
+
+    long long max() const {
+        return this->max_;
+    }
+
+    long long mean() const {
+        return this->total_ == 0 ? 0 : static_cast<long long>(this->sum_ / static_cast<double>(this->total_));
+    }
+
+    // Sample standard deviation, matching Statistics::standardDeviation
+    long long standardDeviation() const {
+        if (this->total_ < 2) return 0;
+        double n = static_cast<double>(this->total_);
+        double variance = (this->sum_squares_ - (this->sum_ * this->sum_) / n) / (n - 1.0);
+        return variance > 0.0 ? static_cast<long long>(std::sqrt(variance)) : 0;
+    }
+
+    // Value at the given percentile (0-100) using the nearest-rank method. The result is the upper
+    // bound of the bucket holding that rank, clamped to the recorded minimum and maximum.
+    long long percentile(double percent) const {
+        if (this->total_ == 0) return 0;
+        if (percent <= 0.0) return this->min();
+        if (percent >= 100.0) return this->max_;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(static_cast<double>(this->total_) * percent / 100.0));
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < this->counts_.size(); ++i) {
+            seen += this->counts_[i];
+            if (seen >= rank) {
+                long long upper = static_cast<long long>(bucketUpper(i));
+                return std::max(this->min(), std::min(upper, this->max_));
+            }
+        }
+        return this->max_;
+    }
+
+    // Number of bucket slots in use; bucket i covers [bucketLower(i), bucketUpper(i)]
+    size_t bucketCount() const {
+        return this->counts_.size();
+    }
+
+    uint64_t bucketValue(size_t index) const {
+        return index < this->counts_.size() ? this->counts_[index] : 0;
+    }
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BUCKET_BITS + 1;
+        return static_cast<size_t>(SUB_BUCKET_COUNT + (static_cast<uint64_t>(shift) - 1) * SUB_BUCKET_HALF
+                                   + ((value >> shift) - SUB_BUCKET_HALF));
+    }
+
+    static uint64_t bucketLower(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        uint64_t offset = index - SUB_BUCKET_COUNT;
+        int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+        return (offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF) << shift;
+    }
+
+    static uint64_t bucketUpper(size_t index) {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        uint64_t offset = index - SUB_BUCKET_COUNT;
+        int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+        return ((offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF + 1) << shift) - 1;
+    }
+
+    // Serialise to a single line: "total min max sum sum_squares index:count ..." (non-empty buckets only)
+    std::string serialize() const {
+        std::ostringstream oss;
+        oss.precision(17);
+        oss << this->total_ << " " << this->min() << " " << this->max_ << " " << this->sum_ << " " << this->sum_squares_;
+        for (size_t i = 0; i < this->counts_.size(); ++i) {
+            if (this->counts_[i] != 0) {
+                oss << " " << i << ":" << this->counts_[i];
+            }
+        }
+        return oss.str();
+    }
+
+    // Parse the output of serialize(); returns false on malformed input
+    static bool deserialize(const std::string& text, Histogram& histogram) {
+        std::istringstream iss(text);
+        Histogram parsed;
+        if (!(iss >> parsed.total_ >> parsed.min_ >> parsed.max_ >> parsed.sum_ >> parsed.sum_squares_)) {
+            return false;
+        }
+        if (parsed.total_ == 0) {
+            parsed.min_ = std::numeric_limits<long long>::max();
+        }
+        // No recorded value lands past this bucket; a larger index can only come from corruption
+        const size_t maxIndex = bucketIndex(static_cast<uint64_t>(std::numeric_limits<long long>::max()));
+        std::string entry;
+        try {
+            while (iss >> entry) {
+                size_t colon = entry.find(':');
+                if (colon == std::string::npos) {
+                    return false;
+                }
+                unsigned long long index = std::stoull(entry.substr(0, colon));
+                uint64_t count = std::stoull(entry.substr(colon + 1));
+                if (index > maxIndex) {
+                    return false;
+                }
+                if (index >= parsed.counts_.size()) {
+                    parsed.counts_.resize(index + 1, 0);
+                }
+                parsed.counts_[index] += count;
+            }
+        } catch (const std::exception&) {
+            return false; // Non-numeric or out-of-range index or count
+        }
+        histogram = std::move(parsed);
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    long long min_;
+    long long max_;
+    double sum_;
+    double sum_squares_;
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_HISTOGRAM_H
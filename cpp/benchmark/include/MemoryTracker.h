@@ -0,0 +1,114 @@
+#ifndef BENCHMARK_LIB_MEMORY_TRACKER_H
+#define BENCHMARK_LIB_MEMORY_TRACKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace benchmark {
+
+// Memory footprint of one benchmark execution
+struct MemoryUsage {
+    bool tracked = false;
+    long long rss_start_kb = 0;
+    long long rss_end_kb = 0;
+    long long rss_peak_kb = 0;   // Highest RSS observed at start, end or by the sampler
+    long long minor_faults = 0;  // Page faults served without I/O during the benchmark
+    long long major_faults = 0;  // Page faults that required I/O during the benchmark
+};
+
+// Tracks RSS and page faults while a benchmark runs. RSS is read from /proc/self/statm at start,
+// end and periodically from a background thread; fault counts are getrusage deltas.
+class MemoryTracker {
+public:
+    explicit MemoryTracker(std::chrono::milliseconds interval = std::chrono::milliseconds(10))
+        : interval_(interval), running_(false), peak_kb_(0) {}
+
+    ~MemoryTracker() {
+        this->stopSampler();
+    }
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // Take the starting snapshot and launch the sampler
+    void start() {
+        this->stopSampler();
+        this->usage_ = MemoryUsage();
+        this->usage_.rss_start_kb = currentRssKb();
+        this->peak_kb_.store(this->usage_.rss_start_kb);
+        getrusage(RUSAGE_SELF, &this->start_rusage_);
+
+        if (this->interval_.count() > 0) {
+            this->running_ = true;
+            this->sampler_ = std::thread([this]() {
+                std::unique_lock<std::mutex> lock(this->mutex_);
+                while (!this->cv_.wait_for(lock, this->interval_, [this]() { return !this->running_; })) {
+                    this->updatePeak(currentRssKb());
+                }
+            });
+        }
+    }
+
+    // Stop the sampler and return the usage since start()
+    MemoryUsage stop() {
+        this->stopSampler();
+        struct rusage end_rusage;
+        getrusage(RUSAGE_SELF, &end_rusage);
+        this->usage_.rss_end_kb = currentRssKb();
+        this->updatePeak(this->usage_.rss_end_kb);
+        this->usage_.rss_peak_kb = this->peak_kb_.load();
+        this->usage_.minor_faults = end_rusage.ru_minflt - this->start_rusage_.ru_minflt;
+        this->usage_.major_faults = end_rusage.ru_majflt - this->start_rusage_.ru_majflt;
+        this->usage_.tracked = true;
+        return this->usage_;
+    }
+
+    // Resident set size of the process in KB, or 0 if /proc is unavailable
+    static long long currentRssKb() {
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+        long long size_pages = 0, resident_pages = 0;
+        int fields = std::fscanf(statm, "%lld %lld", &size_pages, &resident_pages);
+        std::fclose(statm);
+        if (fields != 2) return 0;
+        return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+private:
+    void updatePeak(long long rss_kb) {
+        long long peak = this->peak_kb_.load();
+        while (rss_kb > peak && !this->peak_kb_.compare_exchange_weak(peak, rss_kb)) {
+        }
+    }
+
+    void stopSampler() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->running_ = false;
+        }
+        this->cv_.notify_all();
+        if (this->sampler_.joinable()) {
+            this->sampler_.join();
+        }
+    }
+
+    std::chrono::milliseconds interval_;
+    bool running_;
+    std::atomic<long long> peak_kb_;
+    MemoryUsage usage_;
+    struct rusage start_rusage_;
+    std::thread sampler_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_MEMORY_TRACKER_H
@@ -0,0 +1,225 @@
+#ifndef BENCHMARK_LIB_PROFILER_H
+#define BENCHMARK_LIB_PROFILER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <vector>
+
+namespace benchmark {
+
+// In-process sampling CPU profiler. A SIGPROF timer interrupts whichever thread is consuming CPU,
+// the handler walks the frame-pointer chain starting at the interrupted context and stores the
+// raw return addresses in a preallocated buffer. Symbolisation happens afterwards, when the
+// samples are written as folded stacks ("outer;inner;leaf count") ready for flamegraph.pl.
+// Meaningful stacks require the profiled code to be built with -fno-omit-frame-pointer, and
+// function names of the executable require it to be linked with -rdynamic (ENABLE_EXPORTS).
+class SamplingProfiler {
+public:
+    static constexpr size_t MAX_DEPTH = 64;
+
+    explicit SamplingProfiler(int frequency_hz = 999, size_t max_samples = 16384)
+        : frequency_hz_(frequency_hz > 0 ? frequency_hz : 999), max_samples_(max_samples),
+          next_sample_(0), dropped_(0), running_(false) {}
+
+    ~SamplingProfiler() {
+        this->stop();
+    }
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    // Discard previous samples and start the SIGPROF timer. Only one profiler can run at a time.
+    bool start() {
+        SamplingProfiler* expected = nullptr;
+        if (!activeProfiler().compare_exchange_strong(expected, this)) {
+            return false;
+        }
+        this->frames_.assign(this->max_samples_ * MAX_DEPTH, 0);
+        this->depths_.assign(this->max_samples_, 0);
+        this->next_sample_.store(0);
+        this->dropped_.store(0);
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_sigaction = &SamplingProfiler::onSignal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, &this->previous_action_) != 0) {
+            activeProfiler().store(nullptr);
+            return false;
+        }
+
+        struct itimerval timer;
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = 1000000 / this->frequency_hz_;
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            sigaction(SIGPROF, &this->previous_action_, nullptr);
+            activeProfiler().store(nullptr);
+            return false;
+        }
+        this->running_ = true;
+        return true;
+    }
+
+    // Stop sampling; collected samples remain available for writeFolded
+    void stop() {
+        if (!this->running_) {
+            return;
+        }
+        struct itimerval timer;
+        std::memset(&timer, 0, sizeof(timer));
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        activeProfiler().store(nullptr);
+
+        // A signal may still be in flight; never fall back to the default action, which terminates
+        struct sigaction restore = this->previous_action_;
+        if (!(restore.sa_flags & SA_SIGINFO) && restore.sa_handler == SIG_DFL) {
+            restore.sa_handler = SIG_IGN;
+        }
+        sigaction(SIGPROF, &restore, nullptr);
+        this->running_ = false;
+    }
+
+    // Number of samples captured (excluding dropped ones)
+    size_t sampleCount() const {
+        size_t taken = this->next_sample_.load();
+        return taken < this->max_samples_ ? taken : this->max_samples_;
+    }
+
+    // Number of samples lost because the buffer was full
+    size_t droppedCount() const {
+        return this->dropped_.load();
+    }
+
+    // Symbolise the samples and write them as folded stacks
+    bool writeFolded(const std::string& path) const {
+        std::ofstream ofs(path);
+        if (!ofs.is_open()) {
+            return false; // Failed to open file
+        }
+
+        std::map<uintptr_t, std::string> symbols;
+        std::map<std::string, size_t> stacks;
+        for (size_t sample = 0; sample < this->sampleCount(); ++sample) {
+            size_t depth = this->depths_[sample];
+            if (depth == 0) continue;
+            const uintptr_t* frames = &this->frames_[sample * MAX_DEPTH];
+            std::string stack;
+            // Frames are stored leaf first; folded stacks are written root first
+            for (size_t i = depth; i-- > 0;) {
+                auto it = symbols.find(frames[i]);
+                if (it == symbols.end()) {
+                    // Return addresses point past the call; step back into the calling instruction
+                    it = symbols.emplace(frames[i], symbolize(i == 0 ? frames[i] : frames[i] - 1)).first;
+                }
+                if (!stack.empty()) stack += ';';
+                stack += it->second;
+            }
+            stacks[stack]++;
+        }
+
+        for (const auto& pair : stacks) {
+            ofs << pair.first << " " << pair.second << "\n";
+        }
+        ofs.close();
+        return true;
+    }
+
+private:
+    static std::atomic<SamplingProfiler*>& activeProfiler() {
+        static std::atomic<SamplingProfiler*> active(nullptr);
+        return active;
+    }
+
+    // Async-signal-safe: only atomics and reads of the interrupted stack
+    static void onSignal(int, siginfo_t*, void* context) {
+        SamplingProfiler* profiler = activeProfiler().load(std::memory_order_acquire);
+        if (!profiler) return;
+        size_t sample = profiler->next_sample_.fetch_add(1, std::memory_order_relaxed);
+        if (sample >= profiler->max_samples_) {
+            profiler->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        uintptr_t pc = 0, fp = 0, sp = 0;
+        const ucontext_t* uc = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+        pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+        fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+        sp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__aarch64__)
+        pc = static_cast<uintptr_t>(uc->uc_mcontext.pc);
+        fp = static_cast<uintptr_t>(uc->uc_mcontext.regs[29]);
+        sp = static_cast<uintptr_t>(uc->uc_mcontext.sp);
+#else
+        (void)uc;
+        pc = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+        fp = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+        sp = fp;
+#endif
+
+        uintptr_t* frames = &profiler->frames_[sample * MAX_DEPTH];
+        size_t depth = 0;
+        frames[depth++] = pc;
+        // Each frame holds [saved frame pointer, return address]; accept only frames that move up
+        // the stack by a plausible amount so a clobbered frame pointer ends the walk
+        const uintptr_t max_frame = 8 * 1024 * 1024;
+        while (depth < MAX_DEPTH && fp >= sp && fp - sp < max_frame && (fp & (sizeof(uintptr_t) - 1)) == 0) {
+            const uintptr_t* frame = reinterpret_cast<const uintptr_t*>(fp);
+            uintptr_t return_address = frame[1];
+            uintptr_t next_fp = frame[0];
+            if (return_address == 0) break;
+            frames[depth++] = return_address;
+            if (next_fp <= fp) break;
+            sp = fp;
+            fp = next_fp;
+        }
+        profiler->depths_[sample] = static_cast<uint8_t>(depth);
+    }
+
+    static std::string symbolize(uintptr_t address) {
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            std::string name = (status == 0 && demangled) ? demangled : info.dli_sname;
+            std::free(demangled);
+            return name;
+        }
+        char buffer[32];
+        if (dladdr(reinterpret_cast<void*>(address), &info) && info.dli_fname) {
+            std::snprintf(buffer, sizeof(buffer), "0x%llx",
+                          static_cast<unsigned long long>(address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+            std::string module = info.dli_fname;
+            size_t slash = module.find_last_of('/');
+            return module.substr(slash == std::string::npos ? 0 : slash + 1) + "+" + buffer;
+        }
+        std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(address));
+        return buffer;
+    }
+
+    int frequency_hz_;
+    size_t max_samples_;
+    std::vector<uintptr_t> frames_;   // max_samples_ * MAX_DEPTH return addresses, leaf first
+    std::vector<uint8_t> depths_;     // Number of valid frames per sample
+    std::atomic<size_t> next_sample_;
+    std::atomic<size_t> dropped_;
+    struct sigaction previous_action_;
+    bool running_;
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_PROFILER_H
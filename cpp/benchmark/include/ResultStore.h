@@ -0,0 +1,181 @@
+#ifndef BENCHMARK_LIB_RESULT_STORE_H
+#define BENCHMARK_LIB_RESULT_STORE_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Histogram.h"
+#include "Statistics.h"
+
+namespace benchmark {
+
+// Identifies the run that produced a set of results
+struct RunInfo {
+    std::string run_id;
+    std::string git_revision;
+    std::string host;
+    long long timestamp; // Seconds since the Unix epoch
+
+    // Describe the current process: git revision from BENCHMARK_GIT_REVISION or `git rev-parse`,
+    // host from gethostname()
+    static RunInfo current(const std::string& run_id) {
+        RunInfo info;
+        info.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        info.run_id = run_id.empty() ? std::to_string(info.timestamp) : run_id;
+
+        const char* revision = std::getenv("BENCHMARK_GIT_REVISION");
+        if (revision && *revision) {
+            info.git_revision = revision;
+        } else if (FILE* pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r")) {
+            char buffer[64] = {0};
+            if (fgets(buffer, sizeof(buffer), pipe)) {
+                info.git_revision = buffer;
+                info.git_revision.erase(info.git_revision.find_last_not_of(" \n\r\t") + 1);
+            }
+            pclose(pipe);
+        }
+        if (info.git_revision.empty()) {
+            info.git_revision = "unknown";
+        }
+
+        char host[256] = {0};
+        info.host = gethostname(host, sizeof(host) - 1) == 0 ? host : "unknown";
+        return info;
+    }
+};
+
+// Append-only store of per-operation histograms across benchmark runs. Every line holds one
+// operation of one run:
+//   run_id \t git_revision \t host \t timestamp \t operation \t serialized histogram
+// Bucket counts merge exactly, so any subset of runs can be combined without the raw samples;
+// combined percentiles keep the histogram's bucket resolution (within about 0.8%).
+class ResultStore {
+public:
+    struct Entry {
+        RunInfo run;
+        std::string operation;
+        Histogram histogram;
+    };
+
+    // Selects the runs to aggregate; empty sets match everything
+    struct Filter {
+        std::set<std::string> run_ids;
+        std::set<std::string> git_revisions;
+        std::set<std::string> hosts;
+
+        bool matches(const RunInfo& run) const {
+            return (this->run_ids.empty() || this->run_ids.count(run.run_id))
+                && (this->git_revisions.empty() || this->git_revisions.count(run.git_revision))
+                && (this->hosts.empty() || this->hosts.count(run.host));
+        }
+    };
+
+    explicit ResultStore(const std::string& path) : path_(path) {}
+
+    // Append the results of one run. The run is written with a single append so concurrent
+    // writers never interleave partial runs.
+    bool append(const RunInfo& run, const std::map<std::string, Histogram>& operation_histograms) const {
+        std::ostringstream lines;
+        for (const auto& pair : operation_histograms) {
+            lines << sanitize(run.run_id) << "\t" << sanitize(run.git_revision) << "\t" << sanitize(run.host) << "\t"
+                  << run.timestamp << "\t" << sanitize(pair.first) << "\t" << pair.second.serialize() << "\n";
+        }
+
+        std::ofstream ofs(this->path_, std::ios::app);
+        if (!ofs.is_open()) {
+            return false; // Failed to open file
+        }
+        std::string data = lines.str();
+        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(ofs);
+    }
+
+    bool append(const RunInfo& run, const std::map<std::string, Statistics>& operation_stats) const {
+        std::map<std::string, Histogram> operation_histograms;
+        for (const auto& pair : operation_stats) {
+            operation_histograms[pair.first] = pair.second.toHistogram();
+        }
+        return this->append(run, operation_histograms);
+    }
+
+    // Read every entry; malformed lines are skipped
+    bool load(std::vector<Entry>& entries) const {
+        std::ifstream ifs(this->path_);
+        if (!ifs.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(ifs, line)) {
+            std::vector<std::string> fields;
+            std::istringstream iss(line);
+            std::string field;
+            while (fields.size() < 5 && std::getline(iss, field, '\t')) {
+                fields.push_back(field);
+            }
+            std::string serialized;
+            std::getline(iss, serialized);
+            if (fields.size() != 5) continue;
+
+            Entry entry;
+            entry.run.run_id = fields[0];
+            entry.run.git_revision = fields[1];
+            entry.run.host = fields[2];
+            entry.run.timestamp = std::atoll(fields[3].c_str());
+            entry.operation = fields[4];
+            if (Histogram::deserialize(serialized, entry.histogram)) {
+                entries.push_back(std::move(entry));
+            }
+        }
+        return true;
+    }
+
+    // Merge the histograms of all matching runs per operation
+    std::map<std::string, Histogram> aggregate(const Filter& filter = Filter()) const {
+        std::vector<Entry> entries;
+        this->load(entries);
+        std::map<std::string, Histogram> merged;
+        for (const Entry& entry : entries) {
+            if (filter.matches(entry.run)) {
+                merged[entry.operation].merge(entry.histogram);
+            }
+        }
+        return merged;
+    }
+
+    // Distinct runs in the store, in order of first appearance
+    std::vector<RunInfo> runs() const {
+        std::vector<Entry> entries;
+        this->load(entries);
+        std::vector<RunInfo> result;
+        std::set<std::string> seen;
+        for (const Entry& entry : entries) {
+            if (seen.insert(entry.run.run_id).second) {
+                result.push_back(entry.run);
+            }
+        }
+        return result;
+    }
+
+private:
+    // Tabs and newlines would break the line format
+    static std::string sanitize(std::string value) {
+        for (char& c : value) {
+            if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+        }
+        return value;
+    }
+
+    std::string path_;
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_RESULT_STORE_H
@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <chrono>
 #include <limits>
+#include "Histogram.h"
+#include "MemoryTracker.h"
 
 namespace benchmark {
 
@@ -30,6 +32,17 @@ public:
         deltas_.push_back(nanos);
     }
 
+    // Record a duration measured outside of start_timer/stop_timer
+    void record(long long nanos) {
+        deltas_.push_back(nanos);
+    }
+
+    // Append the deltas collected by another Statistics instance
+    void merge(const Statistics& other) {
+        deltas_.insert(deltas_.end(), other.deltas_.begin(), other.deltas_.end());
+        overflow_ = overflow_ || other.overflow_;
+    }
+
     // Get the number of deltas collected
     size_t count() const {
         return deltas_.size();
@@ -81,6 +94,35 @@ public:
         return sorted_deltas[index];
     }
 
+    // Compute an arbitrary percentile (0-100) of the deltas using the nearest-rank method
+    long long percentile(double percent) const {
+        if (deltas_.empty()) return 0;
+        std::vector<long long> sorted_deltas = deltas_;
+        std::sort(sorted_deltas.begin(), sorted_deltas.end());
+        return percentileOfSorted(sorted_deltas, percent);
+    }
+
+    // Compute several percentiles with a single sort
+    std::vector<long long> percentiles(const std::vector<double>& percents) const {
+        std::vector<long long> values(percents.size(), 0);
+        if (deltas_.empty()) return values;
+        std::vector<long long> sorted_deltas = deltas_;
+        std::sort(sorted_deltas.begin(), sorted_deltas.end());
+        for (size_t i = 0; i < percents.size(); ++i) {
+            values[i] = percentileOfSorted(sorted_deltas, percents[i]);
+        }
+        return values;
+    }
+
+    // Build a log-bucketed histogram of the deltas
+    Histogram toHistogram() const {
+        Histogram histogram;
+        for (long long delta : deltas_) {
+            histogram.record(delta);
+        }
+        return histogram;
+    }
+
     // Compute the standard deviation of the deltas
     long long standardDeviation() const {
         if (deltas_.empty() || deltas_.size() < 2) return 0;
@@ -99,14 +141,31 @@ public:
         return static_cast<long long>(std::sqrt(static_cast<double>(sum_squared_diff) / static_cast<double>(deltas_.size() - 1)));
     }
 
+    // Attach the memory footprint measured while the deltas were collected
+    void setMemoryUsage(const MemoryUsage& usage) {
+        memory_usage_ = usage;
+    }
+
+    const MemoryUsage& memoryUsage() const {
+        return memory_usage_;
+    }
+
     // Get a const reference to the deltas for export purposes
     const std::vector<long long>& getDeltas() const {
         return deltas_;
     }
 
 private:
+    static long long percentileOfSorted(const std::vector<long long>& sorted_deltas, double percent) {
+        if (percent <= 0.0) return sorted_deltas.front();
+        if (percent >= 100.0) return sorted_deltas.back();
+        size_t rank = static_cast<size_t>(std::ceil(sorted_deltas.size() * percent / 100.0));
+        return sorted_deltas[rank > 0 ? rank - 1 : 0];
+    }
+
     std::vector<long long> deltas_;
     TimePoint start_time_;
+    MemoryUsage memory_usage_;
     mutable bool overflow_;
 };
 
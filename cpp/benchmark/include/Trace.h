@@ -0,0 +1,190 @@
+#ifndef BENCHMARK_LIB_TRACE_H
+#define BENCHMARK_LIB_TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace benchmark {
+
+// Operation types that can be captured in a workload trace
+enum class TraceOp : uint8_t {
+    READ = 0,
+    WRITE = 1,
+    UPDATE = 2,
+    LOCK = 3,
+    UNLOCK = 4,
+    PUBLISH = 5,
+    SUBSCRIBE = 6
+};
+
+// Human readable name of a trace operation, used as the operation label in exports
+inline const char* traceOpName(TraceOp op) {
+    switch (op) {
+        case TraceOp::READ: return "Read";
+        case TraceOp::WRITE: return "Write";
+        case TraceOp::UPDATE: return "Update";
+        case TraceOp::LOCK: return "Lock";
+        case TraceOp::UNLOCK: return "Unlock";
+        case TraceOp::PUBLISH: return "Publish";
+        case TraceOp::SUBSCRIBE: return "Subscribe";
+        default: return "Unknown";
+    }
+}
+
+// A single captured operation. The timestamp is relative to the start of the capture.
+struct TraceRecord {
+    TraceOp op;
+    uint64_t timestamp_ns;
+    std::string key;       // Data key or channel name
+    uint32_t value_size;   // Payload size in bytes (0 for operations without a payload)
+};
+
+// Binary trace layout:
+//   header  : "BMTRACE" + format version byte
+//   record  : op (1 byte), timestamp delta (varint), key reference (varint), value size (varint)
+// Key references index a dictionary built while writing: 0 introduces a new key
+// (varint length + bytes, assigned the next id), n > 0 refers to the n-th key seen.
+class TraceWriter {
+public:
+    static constexpr char MAGIC[8] = {'B', 'M', 'T', 'R', 'A', 'C', 'E', 1};
+
+    explicit TraceWriter(const std::string& path)
+        : ofs_(path, std::ios::binary | std::ios::trunc), last_timestamp_(0), records_(0) {
+        if (this->ofs_.is_open()) {
+            this->ofs_.write(MAGIC, sizeof(MAGIC));
+        }
+    }
+
+    bool isOpen() const {
+        return this->ofs_.is_open();
+    }
+
+    // Append a record; timestamps must be non-decreasing
+    void write(const TraceRecord& record) {
+        uint64_t delta = record.timestamp_ns >= this->last_timestamp_
+            ? record.timestamp_ns - this->last_timestamp_ : 0;
+        this->last_timestamp_ = record.timestamp_ns > this->last_timestamp_
+            ? record.timestamp_ns : this->last_timestamp_;
+
+        this->ofs_.put(static_cast<char>(record.op));
+        this->writeVarint(delta);
+
+        auto it = this->key_ids_.find(record.key);
+        if (it != this->key_ids_.end()) {
+            this->writeVarint(it->second);
+        } else {
+            uint64_t id = this->key_ids_.size() + 1;
+            this->key_ids_.emplace(record.key, id);
+            this->writeVarint(0);
+            this->writeVarint(record.key.size());
+            this->ofs_.write(record.key.data(), static_cast<std::streamsize>(record.key.size()));
+        }
+
+        this->writeVarint(record.value_size);
+        this->records_++;
+    }
+
+    void flush() {
+        this->ofs_.flush();
+    }
+
+    size_t recordCount() const {
+        return this->records_;
+    }
+
+private:
+    void writeVarint(uint64_t value) {
+        while (value >= 0x80) {
+            this->ofs_.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        this->ofs_.put(static_cast<char>(value));
+    }
+
+    std::ofstream ofs_;
+    std::unordered_map<std::string, uint64_t> key_ids_;
+    uint64_t last_timestamp_;
+    size_t records_;
+};
+
+// Reads a trace produced by TraceWriter
+class TraceReader {
+public:
+    // Load every record of the trace at path; returns false on a missing file or malformed data
+    static bool readAll(const std::string& path, std::vector<TraceRecord>& records) {
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open()) {
+            return false;
+        }
+        // File size bounds every length read from the file, so corrupt data cannot ask for more
+        const std::streamoff file_size = ifs.tellg();
+        ifs.seekg(0);
+
+        char magic[sizeof(TraceWriter::MAGIC)];
+        if (!ifs.read(magic, sizeof(magic)) || std::memcmp(magic, TraceWriter::MAGIC, sizeof(magic)) != 0) {
+            return false;
+        }
+
+        std::vector<std::string> keys;
+        uint64_t timestamp = 0;
+        int op;
+        while ((op = ifs.get()) != std::char_traits<char>::eof()) {
+            uint64_t delta, key_ref, value_size;
+            if (!readVarint(ifs, delta) || !readVarint(ifs, key_ref)) {
+                return false;
+            }
+
+            if (key_ref == 0) {
+                uint64_t length;
+                if (!readVarint(ifs, length)) {
+                    return false;
+                }
+                std::streamoff position = ifs.tellg();
+                if (position < 0 || length > static_cast<uint64_t>(file_size - position)) {
+                    return false; // Longer than the rest of the file: corrupt or truncated
+                }
+                std::string key(length, '\0');
+                if (!ifs.read(&key[0], static_cast<std::streamsize>(length))) {
+                    return false;
+                }
+                keys.push_back(std::move(key));
+                key_ref = keys.size();
+            } else if (key_ref > keys.size()) {
+                return false;
+            }
+
+            if (!readVarint(ifs, value_size)) {
+                return false;
+            }
+
+            timestamp += delta;
+            records.push_back(TraceRecord{static_cast<TraceOp>(op), timestamp, keys[key_ref - 1],
+                                          static_cast<uint32_t>(value_size)});
+        }
+        return true;
+    }
+
+private:
+    static bool readVarint(std::ifstream& ifs, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = ifs.get();
+            if (byte == std::char_traits<char>::eof()) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_TRACE_H
@@ -0,0 +1,88 @@
+#ifndef BENCHMARK_LIB_TRACE_REPLAYER_H
+#define BENCHMARK_LIB_TRACE_REPLAYER_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Statistics.h"
+#include "Trace.h"
+
+namespace benchmark {
+
+// Replays a captured trace through user supplied executors and measures per-operation latency.
+// The replayer itself knows nothing about Redis: each worker thread asks the factory for an
+// executor (typically owning its own connection) and hands it the records of its partition.
+class TraceReplayer {
+public:
+    enum Speed {
+        ORIGINAL,  // Honour the captured inter-arrival times
+        SCALED,    // Inter-arrival times divided by the scale factor (2.0 replays twice as fast)
+        MAX_SPEED  // Issue operations back to back
+    };
+
+    using Executor = std::function<void(const TraceRecord&)>;
+    using ExecutorFactory = std::function<Executor(size_t thread_index)>;
+
+    TraceReplayer(Speed speed = ORIGINAL, double scale = 1.0, size_t threads = 1)
+        : speed_(speed), scale_(scale > 0.0 ? scale : 1.0), threads_(threads > 0 ? threads : 1) {}
+
+    // Replay the records and return latency statistics keyed by operation name.
+    // Records are partitioned by key so that all operations on a key keep their relative order.
+    std::map<std::string, Statistics> replay(const std::vector<TraceRecord>& records,
+                                             const ExecutorFactory& factory) const {
+        std::vector<std::vector<const TraceRecord*>> partitions(this->threads_);
+        std::hash<std::string> hasher;
+        for (const TraceRecord& record : records) {
+            partitions[hasher(record.key) % this->threads_].push_back(&record);
+        }
+
+        std::vector<std::map<std::string, Statistics>> thread_stats(this->threads_);
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < this->threads_; ++i) {
+            workers.emplace_back([this, i, start, &partitions, &thread_stats, &factory]() {
+                Executor executor = factory(i);
+                for (const TraceRecord* record : partitions[i]) {
+                    this->pace(start, record->timestamp_ns);
+                    Statistics& stats = thread_stats[i][traceOpName(record->op)];
+                    stats.start_timer();
+                    executor(*record);
+                    stats.stop_timer();
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        std::map<std::string, Statistics> merged;
+        for (const auto& per_thread : thread_stats) {
+            for (const auto& pair : per_thread) {
+                merged[pair.first].merge(pair.second);
+            }
+        }
+        return merged;
+    }
+
+private:
+    // Sleep until the record's scheduled issue time for the configured speed
+    void pace(std::chrono::steady_clock::time_point start, uint64_t timestamp_ns) const {
+        if (this->speed_ == MAX_SPEED) {
+            return;
+        }
+        double factor = this->speed_ == SCALED ? this->scale_ : 1.0;
+        auto offset = std::chrono::nanoseconds(static_cast<long long>(static_cast<double>(timestamp_ns) / factor));
+        std::this_thread::sleep_until(start + offset);
+    }
+
+    Speed speed_;
+    double scale_;
+    size_t threads_;
+};
+
+} // namespace benchmark
+
+#endif // BENCHMARK_LIB_TRACE_REPLAYER_H
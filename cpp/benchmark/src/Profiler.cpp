@@ -0,0 +1,9 @@
+#include "Profiler.h"
+
+namespace benchmark {
+
+// Implementation file for SamplingProfiler class.
+// Currently, all methods are defined inline in the header file.
+// This file is included for future expansion if non-inline implementations are needed.
+
+} // namespace benchmark
@@ -0,0 +1,9 @@
+#include "ResultStore.h"
+
+namespace benchmark {
+
+// Implementation file for ResultStore class.
+// Currently, all methods are defined inline in the header file.
+// This file is included for future expansion if non-inline implementations are needed.
+
+} // namespace benchmark
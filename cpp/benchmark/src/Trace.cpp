@@ -0,0 +1,9 @@
+#include "Trace.h"
+
+namespace benchmark {
+
+// Implementation file for TraceWriter and TraceReader classes.
+// Currently, all methods are defined inline in the header file.
+// This file is included for future expansion if non-inline implementations are needed.
+
+} // namespace benchmark
@@ -0,0 +1,9 @@
+#include "TraceReplayer.h"
+
+namespace benchmark {
+
+// Implementation file for TraceReplayer class.
+// Currently, all methods are defined inline in the header file.
+// This file is included for future expansion if non-inline implementations are needed.
+
+} // namespace benchmark
@@ -0,0 +1,97 @@
+#include "CsvExporter.h"
+#include "ResultStore.h"
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Split a comma separated command-line value into a set
+std::set<std::string> splitList(const std::string& value) {
+    std::set<std::string> items;
+    std::istringstream iss(value);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if (!item.empty()) items.insert(item);
+    }
+    return items;
+}
+
+} // namespace
+
+// Merge any subset of runs from a result store into combined statistics, histograms and percentiles
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: benchmark_aggregate <store> [--list] [--runs id,...] [--revisions rev,...] [--hosts host,...]\n"
+                  << "                           [--project name] [--testrun id] [--unit ns|us|ms|s] [--output dir]\n";
+        return 1;
+    }
+
+    benchmark::ResultStore store(argv[1]);
+    benchmark::ResultStore::Filter filter;
+    std::string project_name = "aggregate";
+    std::string test_run = "";
+    std::string output_dir = "results/";
+    bool list_only = false;
+    benchmark::CsvExporter::TimeUnit time_unit = benchmark::CsvExporter::NANOSECONDS;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--list") {
+            list_only = true;
+        } else if (arg == "--runs" && i + 1 < argc) {
+            filter.run_ids = splitList(argv[++i]);
+        } else if (arg == "--revisions" && i + 1 < argc) {
+            filter.git_revisions = splitList(argv[++i]);
+        } else if (arg == "--hosts" && i + 1 < argc) {
+            filter.hosts = splitList(argv[++i]);
+        } else if (arg == "--project" && i + 1 < argc) {
+            project_name = argv[++i];
+        } else if (arg == "--testrun" && i + 1 < argc) {
+            test_run = "_" + std::string(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_dir = argv[++i];
+        } else if (arg == "--unit" && i + 1 < argc) {
+            std::string unit_str = argv[++i];
+            if (unit_str == "us") {
+                time_unit = benchmark::CsvExporter::MICROSECONDS;
+            } else if (unit_str == "ms") {
+                time_unit = benchmark::CsvExporter::MILLISECONDS;
+            } else if (unit_str == "s") {
+                time_unit = benchmark::CsvExporter::SECONDS;
+            } else if (unit_str != "ns") {
+                std::cerr << "Invalid time unit: " << unit_str << ". Using default (ns)." << std::endl;
+            }
+        }
+    }
+
+    if (list_only) {
+        for (const benchmark::RunInfo& run : store.runs()) {
+            std::cout << run.run_id << "\t" << run.git_revision << "\t" << run.host << "\t" << run.timestamp << "\n";
+        }
+        return 0;
+    }
+
+    std::map<std::string, benchmark::Histogram> merged = store.aggregate(filter);
+    if (merged.empty()) {
+        std::cerr << "No matching runs found in " << argv[1] << "\n";
+        return 1;
+    }
+
+    for (const auto& pair : merged) {
+        const benchmark::Histogram& histogram = pair.second;
+        std::cout << pair.first << ": count=" << histogram.count() << " mean=" << histogram.mean()
+                  << "ns p50=" << histogram.percentile(50.0) << "ns p99=" << histogram.percentile(99.0)
+                  << "ns p99.9=" << histogram.percentile(99.9) << "ns max=" << histogram.max() << "ns\n";
+    }
+
+    benchmark::CsvExporter exporter(project_name, test_run, time_unit);
+    exporter.setOutputDir(output_dir);
+    bool export_success = exporter.exportStatsToCsv(merged)
+        && exporter.exportHistogramToCsv(merged)
+        && exporter.exportPercentilesToCsv(merged);
+    if (!export_success) {
+        std::cerr << "Failed to export aggregated results to CSV.\n";
+        return 1;
+    }
+    std::cout << "Aggregated results exported to " << output_dir << project_name << "_{stats,hist,percentiles}" << test_run << ".csv\n";
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef BENCHMARK_TIME_JSON_PAYLOAD_H
+#define BENCHMARK_TIME_JSON_PAYLOAD_H
+
+#include <string>
+
+// Message of exactly `size` bytes shaped like the verbose JSON the applications publish: an
+// array of sensor records, cut at `size`. Repetitive enough that compression behaves as it does
+// on real payloads, unlike a run of identical characters.
+inline std::string jsonPayload(size_t size) {
+    std::string payload = "[";
+    for (size_t i = 0; payload.size() < size; ++i) {
+        payload += "{\"id\":" + std::to_string(i) + ",\"sensor\":\"temperature-" + std::to_string(i % 97)
+            + "\",\"status\":\"nominal\",\"reading\":{\"value\":" + std::to_string(18 + (i * 7) % 13)
+            + "." + std::to_string(i % 10) + ",\"unit\":\"celsius\"},\"tags\":[\"building-a\",\"floor-"
+            + std::to_string(i % 5) + "\"]},";
+    }
+    payload.resize(size);
+    return payload;
+}
+
+#endif // BENCHMARK_TIME_JSON_PAYLOAD_H
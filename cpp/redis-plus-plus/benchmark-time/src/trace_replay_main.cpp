@@ -0,0 +1,139 @@
+#include <TraceReplayer.h>
+#include <CsvExporter.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <sw/redis++/redis++.h>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: trace_replay --trace <file> [--speed original|max|<factor>] [--threads N] [--testrun id]\n";
+}
+
+} // namespace
+
+// Replays a trace captured by redis_extended::TraceRecorder against Redis and exports
+// per-operation latency in the same CSV format as the registered benchmarks.
+int main(int argc, char* argv[]) {
+    std::string trace_file;
+    std::string test_run = "";
+    size_t threads = 1;
+    double scale = 1.0;
+    benchmark::TraceReplayer::Speed speed = benchmark::TraceReplayer::ORIGINAL;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--trace" && i + 1 < argc) {
+                trace_file = argv[++i];
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads = std::stoul(argv[++i]);
+            } else if (arg == "--testrun" && i + 1 < argc) {
+                test_run = "_" + std::string(argv[++i]);
+            } else if (arg == "--speed" && i + 1 < argc) {
+                std::string speed_str = argv[++i];
+                if (speed_str == "original") {
+                    speed = benchmark::TraceReplayer::ORIGINAL;
+                } else if (speed_str == "max") {
+                    speed = benchmark::TraceReplayer::MAX_SPEED;
+                } else {
+                    speed = benchmark::TraceReplayer::SCALED;
+                    scale = std::stod(speed_str);
+                }
+            }
+        }
+    } catch (const std::logic_error&) {
+        // std::invalid_argument or std::out_of_range from a non-numeric --threads or --speed
+        printUsage();
+        return 1;
+    }
+    if (trace_file.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<benchmark::TraceRecord> records;
+    if (!benchmark::TraceReader::readAll(trace_file, records)) {
+        std::cerr << "Failed to read trace file: " << trace_file << "\n";
+        return 1;
+    }
+    // Subscriptions are long lived and carry no request latency to replay
+    records.erase(std::remove_if(records.begin(), records.end(), [](const benchmark::TraceRecord& record) {
+        return record.op == benchmark::TraceOp::SUBSCRIBE;
+    }), records.end());
+    std::cout << "Replaying " << records.size() << " operations from " << trace_file
+              << " on " << threads << " thread(s)...\n";
+
+    std::string host = std::getenv("REDIS_HOST") ? std::getenv("REDIS_HOST") : "127.0.0.1";
+    std::string port = std::getenv("REDIS_PORT") ? std::getenv("REDIS_PORT") : "6379";
+    std::string connection = "tcp://" + host + ":" + port;
+
+    // Records whose command failed (timeout, refused connection, WRONGTYPE on a replayed key),
+    // by operation; a failure is counted and the replay goes on
+    std::mutex failures_mutex;
+    std::map<std::string, uint64_t> failures;
+    auto record_failure = [&failures_mutex, &failures](const benchmark::TraceRecord& record, const std::exception& e) {
+        std::lock_guard<std::mutex> lock(failures_mutex);
+        if (failures[benchmark::traceOpName(record.op)]++ == 0) {
+            std::cerr << "First " << benchmark::traceOpName(record.op) << " failure (key " << record.key << "): " << e.what() << "\n";
+        }
+    };
+
+    benchmark::TraceReplayer replayer(speed, scale, threads);
+    auto operation_stats = replayer.replay(records, [&connection, &record_failure](size_t) {
+        // Each worker owns its connection; the payload is synthesised from the recorded size
+        auto redis = std::make_shared<sw::redis::Redis>(connection);
+        auto payload = std::make_shared<std::string>();
+        return [redis, payload, &record_failure](const benchmark::TraceRecord& record) {
+            if (payload->size() < record.value_size) {
+                payload->assign(record.value_size, '-');
+            }
+            sw::redis::StringView value(payload->data(), record.value_size);
+            try {
+                switch (record.op) {
+                    case benchmark::TraceOp::READ:
+                        redis->get(record.key);
+                        break;
+                    case benchmark::TraceOp::WRITE:
+                        redis->set(record.key, value);
+                        break;
+                    case benchmark::TraceOp::UPDATE:
+                        redis->set(record.key, value, std::chrono::milliseconds(0), sw::redis::UpdateType::EXIST);
+                        break;
+                    case benchmark::TraceOp::LOCK:
+                        redis->set("lock:" + record.key, "replay", std::chrono::seconds(30), sw::redis::UpdateType::NOT_EXIST);
+                        break;
+                    case benchmark::TraceOp::UNLOCK:
+                        redis->del("lock:" + record.key);
+                        break;
+                    case benchmark::TraceOp::PUBLISH:
+                        redis->publish(record.key, value);
+                        break;
+                    case benchmark::TraceOp::SUBSCRIBE:
+                        break;
+                }
+            } catch (const std::exception& e) {
+                record_failure(record, e);
+            }
+        };
+    });
+    for (const auto& pair : failures) {
+        std::cerr << pair.second << " " << pair.first << " operation(s) failed\n";
+    }
+
+    std::cout << "Exporting results to CSV...\n";
+    benchmark::CsvExporter exporter("trace_replay", test_run);
+    if (exporter.exportAllToCsv(operation_stats)) {
+        std::cout << "Results exported successfully to trace_replay_raw" << test_run << ".csv, trace_replay_stats" << test_run
+                  << ".csv, trace_replay_hist" << test_run << ".csv and trace_replay_percentiles"
+                  << test_run << ".csv\n";
+    } else {
+        std::cerr << "Failed to export results to CSV.\n";
+    }
+    return 0;
+}
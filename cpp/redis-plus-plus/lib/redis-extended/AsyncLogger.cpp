@@ -0,0 +1,219 @@
+#include "AsyncLogger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <utility>
+
+namespace redis_extended {
+namespace logging {
+
+namespace {
+
+std::atomic<uint64_t> nextLoggerId(1);
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace
+
+// Single-producer / single-consumer ring; head and tail are on separate cache lines
+struct AsyncLogger::Ring {
+    explicit Ring(size_t capacity) : slots(capacity), mask(capacity - 1), head(0), tail(0), orphaned(false), closed(false) {}
+
+    std::vector<std::string> slots;          // Formatted records, capacity reused across laps
+    size_t mask;
+    alignas(64) std::atomic<uint64_t> head;  // Next slot the producer fills
+    alignas(64) std::atomic<uint64_t> tail;  // Next slot the writer drains
+    std::atomic<bool> orphaned;              // Producer thread has exited
+    std::atomic<bool> closed;                // Logger has been destroyed
+};
+
+// Rings of the current thread, one per logger it has used
+struct AsyncLogger::ThreadRings {
+    std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> rings;
+
+    ~ThreadRings() {
+        for (auto& entry : this->rings) {
+            entry.second->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+AsyncLogger::AsyncLogger(int fd, size_t ringCapacity, FullPolicy policy, size_t batchBytes)
+    : id_(nextLoggerId++), fd_(fd), ringCapacity_(roundUpToPowerOfTwo(std::max<size_t>(ringCapacity, 2))),
+      policy_(policy), batchBytes_(std::max<size_t>(batchBytes, 1)), running_(true), produced_(0), written_(0),
+      dropped_(0), blocked_(0), writeCalls_(0), bytes_(0), idle_(false), buffered_(0) {
+    this->writer_ = std::thread([this]() { this->run(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        // Under the lock so the writer cannot miss the flag between its check and its wait
+        std::lock_guard<std::mutex> lock(this->wakeMutex_);
+        this->running_ = false;
+        this->wakeCv_.notify_all();
+    }
+    if (this->writer_.joinable()) {
+        this->writer_.join();
+    }
+    std::lock_guard<std::mutex> lock(this->ringsMutex_);
+    for (auto& ring : this->rings_) {
+        ring->closed.store(true, std::memory_order_release);
+    }
+}
+
+void AsyncLogger::log(const std::string& level, const std::string& message) {
+    Ring& ring = this->threadRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    bool waited = false;
+    while (head - ring.tail.load(std::memory_order_acquire) >= ring.slots.size()) {
+        if (this->policy_ == FullPolicy::DROP || !this->running_) {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!waited) {
+            waited = true;
+            this->blocked_.fetch_add(1, std::memory_order_relaxed);
+        }
+        this->wakeWriter();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    // Format in place so the slot's capacity is reused
+    std::string& slot = ring.slots[head & ring.mask];
+    slot.clear();
+    slot.append("[").append(level).append("] ").append(message).push_back('\n');
+    ring.head.store(head + 1, std::memory_order_release);
+    // Sequentially consistent so either the writer sees this record before going idle, or this
+    // thread sees idle_ and wakes it
+    this->produced_.fetch_add(1);
+    if (this->idle_.load()) {
+        this->wakeWriter();
+    }
+}
+
+void AsyncLogger::flush() {
+    uint64_t target = this->produced_.load();
+    std::unique_lock<std::mutex> lock(this->wakeMutex_);
+    while (this->written_.load() < target && this->running_) {
+        this->idle_ = false;
+        this->wakeCv_.notify_all();
+        this->wakeCv_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+AsyncLogger::Stats AsyncLogger::stats() const {
+    Stats stats;
+    stats.written = this->written_.load();
+    stats.dropped = this->dropped_.load();
+    stats.blocked = this->blocked_.load();
+    stats.writeCalls = this->writeCalls_.load();
+    stats.bytes = this->bytes_.load();
+    return stats;
+}
+
+AsyncLogger::Ring& AsyncLogger::threadRing() {
+    thread_local ThreadRings local;
+    for (auto& entry : local.rings) {
+        if (entry.first == this->id_) {
+            return *entry.second;
+        }
+    }
+    // Forget rings of loggers that no longer exist before registering a new one
+    local.rings.erase(std::remove_if(local.rings.begin(), local.rings.end(), [](const auto& entry) {
+        return entry.second->closed.load(std::memory_order_acquire);
+    }), local.rings.end());
+
+    auto ring = std::make_shared<Ring>(this->ringCapacity_);
+    {
+        std::lock_guard<std::mutex> lock(this->ringsMutex_);
+        this->rings_.push_back(ring);
+    }
+    local.rings.emplace_back(this->id_, ring);
+    return *ring;
+}
+
+size_t AsyncLogger::drain(std::string& buffer) {
+    size_t taken = 0;
+    std::lock_guard<std::mutex> lock(this->ringsMutex_);
+    for (auto& ring : this->rings_) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            buffer.append(ring->slots[tail & ring->mask]);
+            ++this->buffered_;
+            ++taken;
+            if (buffer.size() >= this->batchBytes_) {
+                ring->tail.store(tail + 1, std::memory_order_release);
+                this->writeOut(buffer);
+            }
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    // Rings of exited threads are dropped once empty
+    this->rings_.erase(std::remove_if(this->rings_.begin(), this->rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+        return ring->orphaned.load(std::memory_order_acquire)
+            && ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+    }), this->rings_.end());
+    return taken;
+}
+
+void AsyncLogger::writeOut(std::string& buffer) {
+    size_t offset = 0;
+    while (offset < buffer.size()) {
+        ssize_t written = ::write(this->fd_, buffer.data() + offset, buffer.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break; // Descriptor unusable; the records are lost
+        }
+        this->writeCalls_.fetch_add(1, std::memory_order_relaxed);
+        this->bytes_.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+        offset += static_cast<size_t>(written);
+    }
+    buffer.clear();
+    this->written_.fetch_add(this->buffered_);
+    this->buffered_ = 0;
+    this->wakeCv_.notify_all();
+}
+
+void AsyncLogger::wakeWriter() {
+    if (this->idle_.exchange(false)) {
+        std::lock_guard<std::mutex> lock(this->wakeMutex_);
+        this->wakeCv_.notify_all();
+    }
+}
+
+void AsyncLogger::run() {
+    std::string buffer;
+    buffer.reserve(this->batchBytes_ * 2);
+    while (true) {
+        // Read the flag before draining so records logged before stop are always written
+        bool stopping = !this->running_;
+        size_t taken = this->drain(buffer);
+        if (taken == 0) {
+            if (!buffer.empty()) {
+                this->writeOut(buffer);
+            }
+            if (stopping) {
+                break;
+            }
+            // Sleep until a producer or flush() clears idle_; the timeout is only a safety net
+            std::unique_lock<std::mutex> lock(this->wakeMutex_);
+            this->idle_ = true;
+            if (this->produced_.load() == this->written_.load()) {
+                this->wakeCv_.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                    return !this->idle_.load() || !this->running_;
+                });
+            }
+            this->idle_ = false;
+        }
+    }
+}
+
+} // namespace logging
+} // namespace redis_extended
@@ -0,0 +1,103 @@
+#ifndef REDIS_EXTENDED_ASYNC_LOGGER_H
+#define REDIS_EXTENDED_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Logging.h"
+
+namespace redis_extended {
+namespace logging {
+
+// ILogger that never blocks on I/O. Each producing thread gets its own single-producer /
+// single-consumer ring of preallocated record slots; a background writer drains every ring into
+// one buffer and emits it with large write() calls on a file descriptor. Slots keep their string
+// capacity, so steady-state logging does not allocate. When a ring is full the record is either
+// dropped (counted) or the producer waits for the writer, depending on the policy.
+class AsyncLogger : public ILogger {
+public:
+    // What a producer does when its ring is full
+    enum class FullPolicy {
+        DROP,  // Discard the record and count it
+        BLOCK  // Wait until the writer frees a slot
+    };
+
+    // Writer counters
+    struct Stats {
+        uint64_t written = 0;     // Records handed to write()
+        uint64_t dropped = 0;     // Records discarded under FullPolicy::DROP
+        uint64_t blocked = 0;     // Records whose producer had to wait under FullPolicy::BLOCK
+        uint64_t writeCalls = 0;  // write() system calls issued
+        uint64_t bytes = 0;       // Bytes written
+    };
+
+    // Constructor; the descriptor is not closed by the logger. ringCapacity is rounded up to a
+    // power of two.
+    explicit AsyncLogger(int fd = STDOUT_FILENO, size_t ringCapacity = 4096,
+                         FullPolicy policy = FullPolicy::DROP, size_t batchBytes = 64 * 1024);
+
+    // Destructor; drains every ring before returning
+    ~AsyncLogger() override;
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    using ILogger::log;
+    void log(const std::string& level, const std::string& message) override;
+
+    // Block until every record logged before the call has been written
+    void flush();
+
+    Stats stats() const;
+
+private:
+    struct Ring;
+    struct ThreadRings;
+
+    const uint64_t id_;                  // Distinguishes loggers in the per-thread ring table
+    int fd_;                             // Destination descriptor
+    size_t ringCapacity_;                // Slots per producer ring (power of two)
+    FullPolicy policy_;                  // Behaviour on a full ring
+    size_t batchBytes_;                  // write() once this much is buffered
+
+    std::mutex ringsMutex_;              // Guards rings_
+    std::vector<std::shared_ptr<Ring>> rings_;
+
+    std::atomic<bool> running_;          // Writer keeps going while set
+    std::atomic<uint64_t> produced_;     // Records accepted into rings
+    std::atomic<uint64_t> written_;      // Records passed to write(), compared against produced_ by flush()
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> blocked_;
+    std::atomic<uint64_t> writeCalls_;
+    std::atomic<uint64_t> bytes_;
+    std::mutex wakeMutex_;               // Pairs with wakeCv_ for idle waits and flush()
+    std::condition_variable wakeCv_;
+    std::atomic<bool> idle_;             // Writer found nothing to drain and is waiting for a record
+    std::thread writer_;
+    size_t buffered_;                    // Records in the writer's buffer (writer thread only)
+
+    // Ring owned by the calling thread, created on first use
+    Ring& threadRing();
+
+    // Move every available record into buffer; returns the number of records taken
+    size_t drain(std::string& buffer);
+
+    // Write the whole buffer, retrying on partial writes and EINTR
+    void writeOut(std::string& buffer);
+
+    // Wake the writer if it is idle; only the first record after an idle period takes the lock
+    void wakeWriter();
+
+    void run();
+};
+
+} // namespace logging
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_ASYNC_LOGGER_H
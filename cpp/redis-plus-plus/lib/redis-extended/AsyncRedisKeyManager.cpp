@@ -0,0 +1,219 @@
+#include "AsyncRedisKeyManager.h"
+#include "RedisKeyManager.h"
+#include "RedisLeaseLock.h"
+#include "RedisScriptRegistry.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include <memory>
+
+namespace redis_extended {
+
+namespace {
+
+// Adapt a callback-based operation to a future
+template <typename T, typename Operation>
+std::future<T> toFuture(Operation&& operation) {
+    auto promise = std::make_shared<std::promise<T>>();
+    std::future<T> future = promise->get_future();
+    operation([promise](T result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+} // namespace
+
+AsyncRedisKeyManager::AsyncRedisKeyManager(sw::redis::AsyncRedis& redis, const std::string& key, uint8_t threadId,
+                                           logging::ILogger* logger, std::chrono::milliseconds lockTtl)
+    : redis_(redis), key_(key), lockKey_("lock:" + key), wakeKey_("lock:" + key + ":wake"),
+      fenceKey_("lock:" + key + ":fence"), versionKey_("version:" + key), threadId_(threadId),
+      logger_(logger), tracer_(nullptr), lockTtl_(lockTtl), heldFence_(0) {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Initialized AsyncRedisKeyManager for key: " + key_);
+}
+
+AsyncRedisKeyManager::~AsyncRedisKeyManager() {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Destroyed AsyncRedisKeyManager for key: " + key_);
+}
+
+void AsyncRedisKeyManager::tryLock(Callback callback) {
+    std::string token = RedisLeaseLock::generateToken();
+    acquire(token, [this, token, callback](long long fence) {
+        if (fence > 0) {
+            std::lock_guard<std::mutex> guard(tokenMutex_);
+            heldToken_ = token;
+            heldFence_ = fence;
+        }
+        callback(fence > 0);
+    });
+}
+
+std::future<bool> AsyncRedisKeyManager::tryLock() {
+    return toFuture<bool>([this](Callback callback) { tryLock(std::move(callback)); });
+}
+
+void AsyncRedisKeyManager::unlock(Callback callback) {
+    std::string token;
+    {
+        std::lock_guard<std::mutex> guard(tokenMutex_);
+        token.swap(heldToken_);
+    }
+    if (token.empty()) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Lock for key " + key_ + " is not held by this manager");
+        callback(false);
+        return;
+    }
+    release(token, std::move(callback));
+}
+
+std::future<bool> AsyncRedisKeyManager::unlock() {
+    return toFuture<bool>([this](Callback callback) { unlock(std::move(callback)); });
+}
+
+void AsyncRedisKeyManager::write(const std::string& value, Callback callback) {
+    lockedSet(value, false, benchmark::TraceOp::WRITE, std::move(callback));
+}
+
+std::future<bool> AsyncRedisKeyManager::write(const std::string& value) {
+    return toFuture<bool>([this, &value](Callback callback) { write(value, std::move(callback)); });
+}
+
+void AsyncRedisKeyManager::update(const std::string& newValue, Callback callback) {
+    lockedSet(newValue, true, benchmark::TraceOp::UPDATE, std::move(callback));
+}
+
+std::future<bool> AsyncRedisKeyManager::update(const std::string& newValue) {
+    return toFuture<bool>([this, &newValue](Callback callback) { update(newValue, std::move(callback)); });
+}
+
+void AsyncRedisKeyManager::read(ReadCallback callback) {
+    try {
+        redis_.get(key_, [this, callback](sw::redis::Future<sw::redis::OptionalString>&& future) {
+            sw::redis::OptionalString value;
+            try {
+                value = future.get();
+                trace(benchmark::TraceOp::READ, value ? value->size() : 0);
+                if (!value) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
+                }
+            } catch (const std::exception& e) {
+                REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
+            }
+            callback(std::move(value));
+        });
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
+        callback(sw::redis::OptionalString());
+    }
+}
+
+std::future<sw::redis::OptionalString> AsyncRedisKeyManager::read() {
+    return toFuture<sw::redis::OptionalString>([this](ReadCallback callback) { read(std::move(callback)); });
+}
+
+void AsyncRedisKeyManager::setTraceRecorder(TraceRecorder* recorder) {
+    tracer_ = recorder;
+}
+
+void AsyncRedisKeyManager::acquire(const std::string& token, AcquireCallback callback) {
+    try {
+        // Same script as RedisLeaseLock so fenced writers see leases taken here
+        redis_.eval<long long>(RedisLeaseLock::acquireScript().body(), {lockKey_, fenceKey_}, {token, std::to_string(lockTtl_.count())},
+                               [this, callback](sw::redis::Future<long long>&& future) {
+            long long fence = 0;
+            try {
+                fence = future.get();
+                trace(benchmark::TraceOp::LOCK);
+                if (fence <= 0) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Failed to acquire lock for key: " + key_);
+                }
+            } catch (const std::exception& e) {
+                REDIS_EXTENDED_LOG(logger_, ERROR, "Error trying to lock key " + key_ + ": " + e.what());
+            }
+            callback(fence);
+        });
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error trying to lock key " + key_ + ": " + e.what());
+        callback(0);
+    }
+}
+
+void AsyncRedisKeyManager::release(const std::string& token, Callback callback) {
+    try {
+        redis_.eval<long long>(RedisLeaseLock::releaseScript().body(), {lockKey_, wakeKey_}, {token, std::to_string(lockTtl_.count())},
+                               [this, callback](sw::redis::Future<long long>&& future) {
+            bool released = false;
+            try {
+                released = future.get() == 1;
+                trace(benchmark::TraceOp::UNLOCK);
+                if (!released) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Lock for key " + key_ + " expired before release");
+                }
+            } catch (const std::exception& e) {
+                REDIS_EXTENDED_LOG(logger_, ERROR, "Error releasing lock for key " + key_ + ": " + e.what());
+            }
+            callback(released);
+        });
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error releasing lock for key " + key_ + ": " + e.what());
+        callback(false);
+    }
+}
+
+void AsyncRedisKeyManager::lockedSet(const std::string& value, bool mustExist, benchmark::TraceOp op, Callback callback) {
+    std::string heldToken;
+    long long heldFence = 0;
+    {
+        std::lock_guard<std::mutex> guard(tokenMutex_);
+        heldToken = heldToken_;
+        heldFence = heldFence_;
+    }
+    if (!heldToken.empty()) {
+        // Chain on the lease taken through tryLock(); unlock() releases it
+        fencedSet(value, mustExist, heldToken, heldFence, op, std::move(callback));
+        return;
+    }
+    std::string token = RedisLeaseLock::generateToken();
+    acquire(token, [this, token, value, mustExist, op, callback](long long fence) {
+        if (fence <= 0) {
+            callback(false);
+            return;
+        }
+        fencedSet(value, mustExist, token, fence, op, [this, token, callback](bool stored) {
+            release(token, [callback, stored](bool) { callback(stored); });
+        });
+    });
+}
+
+void AsyncRedisKeyManager::fencedSet(const std::string& value, bool mustExist, const std::string& token, long long fence,
+                                     benchmark::TraceOp op, Callback callback) {
+    try {
+        // Same script as RedisKeyManager: owner and fence checked, version bumped
+        redis_.eval<long long>(RedisKeyManager::fencedSetScript().body(), {key_, fenceKey_, versionKey_, lockKey_},
+                               {std::to_string(fence), value, mustExist ? "1" : "0", token},
+                               [this, size = value.size(), op, callback](sw::redis::Future<long long>&& future) {
+            bool stored = false;
+            try {
+                long long result = future.get();
+                stored = result == 1;
+                trace(op, size);
+                if (result == 0) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for update");
+                } else if (result < 0) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Rejected write to key " + key_ + ": lease expired or was taken over");
+                }
+            } catch (const std::exception& e) {
+                REDIS_EXTENDED_LOG(logger_, ERROR, "Error setting key " + key_ + ": " + e.what());
+            }
+            callback(stored);
+        });
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error setting key " + key_ + ": " + e.what());
+        callback(false);
+    }
+}
+
+void AsyncRedisKeyManager::trace(benchmark::TraceOp op, size_t valueSize) const {
+    if (tracer_) {
+        tracer_->record(op, key_, valueSize);
+    }
+}
+
+} // namespace redis_extended
@@ -0,0 +1,99 @@
+#ifndef REDIS_EXTENDED_ASYNC_KEY_MANAGER_H
+#define REDIS_EXTENDED_ASYNC_KEY_MANAGER_H
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <sw/redis++/async_redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+
+// Non-blocking counterpart of RedisKeyManager on sw::redis::AsyncRedis. Every operation is
+// issued on the AsyncRedis event loop and completes through a callback, so a locked write is
+// acquire -> fenced SET -> release chained in callbacks without a thread waiting on any step;
+// with a lease taken through tryLock() writes reuse it and skip acquire and release. The
+// future-returning overloads wrap the callback ones. Callbacks run on the event loop thread and
+// must not block; the manager must outlive its pending operations. Leases are compatible with
+// RedisLeaseLock (same lock key, token check, fence and wake-up list) but are not renewed, and
+// writes go through RedisKeyManager's fenced SET, so they bump the version counter its
+// compareAndSet() checks.
+// Built only with the REDIS_EXTENDED_ASYNC CMake option.
+class AsyncRedisKeyManager {
+public:
+    using Callback = std::function<void(bool)>;
+    using ReadCallback = std::function<void(sw::redis::OptionalString)>;
+
+    // Constructor
+    AsyncRedisKeyManager(sw::redis::AsyncRedis& redis, const std::string& key, uint8_t threadId = 0,
+                         logging::ILogger* logger = nullptr,
+                         std::chrono::milliseconds lockTtl = std::chrono::seconds(30));
+
+    // Destructor
+    ~AsyncRedisKeyManager();
+
+    // Explicit locking; one lease per manager instance
+    void tryLock(Callback callback);
+    std::future<bool> tryLock();
+    void unlock(Callback callback);
+    std::future<bool> unlock();
+
+    // Locked write: acquire a per-operation lease, fenced SET, release (or the held lease only)
+    void write(const std::string& value, Callback callback);
+    std::future<bool> write(const std::string& value);
+
+    // Locked update: as write(), but only if the key exists
+    void update(const std::string& newValue, Callback callback);
+    std::future<bool> update(const std::string& newValue);
+
+    // Plain GET
+    void read(ReadCallback callback);
+    std::future<sw::redis::OptionalString> read();
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+private:
+    sw::redis::AsyncRedis& redis_;     // Reference to the async Redis client
+    std::string key_;                  // Key managed by this instance
+    std::string lockKey_;              // Key used for locking
+    std::string wakeKey_;              // Release signal shared with RedisLeaseLock waiters
+    std::string fenceKey_;             // Fencing counter shared with RedisLeaseLock
+    std::string versionKey_;           // Version counter shared with RedisKeyManager
+    uint8_t threadId_;                 // Thread ID for logging purposes
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    TraceRecorder* tracer_;            // Optional workload trace recorder
+    std::chrono::milliseconds lockTtl_; // Lease duration
+    std::mutex tokenMutex_;            // Guards heldToken_ and heldFence_
+    std::string heldToken_;            // Token of the lease taken through tryLock()
+    long long heldFence_;              // Fencing token of that lease
+
+    // Completion of acquire(): the fencing token, or 0 when the lock was not acquired
+    using AcquireCallback = std::function<void(long long)>;
+
+    // Chainable lease steps shared by the explicit and per-operation locking paths
+    void acquire(const std::string& token, AcquireCallback callback);
+    void release(const std::string& token, Callback callback);
+
+    // Fenced SET under the held lease, or under a per-operation one when none is held
+    void lockedSet(const std::string& value, bool mustExist, benchmark::TraceOp op, Callback callback);
+
+    // Fenced SET under the lease identified by token and fence
+    void fencedSet(const std::string& value, bool mustExist, const std::string& token, long long fence,
+                   benchmark::TraceOp op, Callback callback);
+
+    // Helper function to record an operation on the managed key when tracing is enabled
+    void trace(benchmark::TraceOp op, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_ASYNC_KEY_MANAGER_H
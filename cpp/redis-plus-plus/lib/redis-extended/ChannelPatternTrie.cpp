@@ -0,0 +1,213 @@
+#include "ChannelPatternTrie.h"
+
+namespace redis_extended {
+
+namespace {
+
+const char SEPARATOR = '.';
+const std::string ANY_SEGMENT = "*";
+const std::string REST_SEGMENTS = ">";
+
+} // namespace
+
+struct ChannelPatternTrie::Node {
+    std::unordered_map<std::string, std::unique_ptr<Node>> children; // Literal segments
+    std::unique_ptr<Node> any;  // `*` segment
+    Callback exact;             // Pattern ending at this node
+    Callback rest;              // Pattern ending with `>` below this node
+
+    bool empty() const {
+        return children.empty() && !any && !exact && !rest;
+    }
+};
+
+ChannelPatternTrie::ChannelPatternTrie() : root_(std::make_unique<Node>()), size_(0) {
+}
+
+ChannelPatternTrie::~ChannelPatternTrie() = default;
+
+bool ChannelPatternTrie::insert(const std::string& pattern, Callback callback) {
+    if (!isValid(pattern) || !callback) {
+        return false;
+    }
+    std::vector<std::string> segments = split(pattern);
+    Node* node = this->root_.get();
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const std::string& segment = segments[i];
+        if (segment == REST_SEGMENTS) {
+            if (!node->rest) ++this->size_;
+            node->rest = std::move(callback);
+            return true;
+        }
+        std::unique_ptr<Node>& child = segment == ANY_SEGMENT ? node->any : node->children[segment];
+        if (!child) {
+            child = std::make_unique<Node>();
+        }
+        node = child.get();
+    }
+    if (!node->exact) ++this->size_;
+    node->exact = std::move(callback);
+    return true;
+}
+
+bool ChannelPatternTrie::remove(const std::string& pattern) {
+    if (!isValid(pattern)) {
+        return false;
+    }
+    bool removed = false;
+    this->remove(*this->root_, split(pattern), 0, removed);
+    if (removed) {
+        --this->size_;
+    }
+    return removed;
+}
+
+bool ChannelPatternTrie::contains(const std::string& pattern) const {
+    if (!isValid(pattern)) {
+        return false;
+    }
+    const Node* node = this->root_.get();
+    for (const std::string& segment : split(pattern)) {
+        if (segment == REST_SEGMENTS) {
+            return static_cast<bool>(node->rest);
+        }
+        if (segment == ANY_SEGMENT) {
+            node = node->any.get();
+        } else {
+            auto child = node->children.find(segment);
+            node = child != node->children.end() ? child->second.get() : nullptr;
+        }
+        if (!node) {
+            return false;
+        }
+    }
+    return static_cast<bool>(node->exact);
+}
+
+size_t ChannelPatternTrie::size() const {
+    return this->size_;
+}
+
+void ChannelPatternTrie::clear() {
+    this->root_ = std::make_unique<Node>();
+    this->size_ = 0;
+}
+
+size_t ChannelPatternTrie::dispatch(const std::string& channel, const std::string& message) const {
+    size_t matched = 0;
+    if (this->size_ > 0) {
+        this->match(*this->root_, split(channel), 0, channel, message, matched);
+    }
+    return matched;
+}
+
+bool ChannelPatternTrie::isValid(const std::string& pattern) {
+    std::vector<std::string> segments = split(pattern);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const std::string& segment = segments[i];
+        if (segment.empty()) {
+            return false;
+        }
+        if (segment == REST_SEGMENTS) {
+            if (i + 1 != segments.size()) {
+                return false;
+            }
+        } else if (segment != ANY_SEGMENT && segment.find_first_of("*>") != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ChannelPatternTrie::serverPattern(const std::string& pattern) {
+    std::string prefix;
+    for (const std::string& segment : split(pattern)) {
+        if (segment == ANY_SEGMENT || segment == REST_SEGMENTS) {
+            return escapeGlob(prefix) + "*";
+        }
+        prefix += segment;
+        prefix += SEPARATOR;
+    }
+    return escapeGlob(pattern);
+}
+
+std::vector<std::string> ChannelPatternTrie::coveringServerPatterns(const std::string& channel) {
+    std::vector<std::string> patterns;
+    patterns.push_back(escapeGlob(channel));
+    for (size_t end = channel.rfind(SEPARATOR); end != std::string::npos;
+         end = end > 0 ? channel.rfind(SEPARATOR, end - 1) : std::string::npos) {
+        patterns.push_back(escapeGlob(channel.substr(0, end + 1)) + "*");
+    }
+    patterns.push_back("*");
+    return patterns;
+}
+
+std::vector<std::string> ChannelPatternTrie::split(const std::string& name) {
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (true) {
+        size_t end = name.find(SEPARATOR, start);
+        if (end == std::string::npos) {
+            segments.push_back(name.substr(start));
+            return segments;
+        }
+        segments.push_back(name.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+std::string ChannelPatternTrie::escapeGlob(const std::string& literal) {
+    std::string escaped;
+    escaped.reserve(literal.size());
+    for (char c : literal) {
+        if (c == '*' || c == '?' || c == '[' || c == ']' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void ChannelPatternTrie::match(const Node& node, const std::vector<std::string>& segments, size_t index,
+                               const std::string& channel, const std::string& message, size_t& matched) const {
+    if (index == segments.size()) {
+        if (node.exact) {
+            node.exact(channel, message);
+            ++matched;
+        }
+        return;
+    }
+    if (node.rest) {
+        node.rest(channel, message);
+        ++matched;
+    }
+    auto child = node.children.find(segments[index]);
+    if (child != node.children.end()) {
+        this->match(*child->second, segments, index + 1, channel, message, matched);
+    }
+    if (node.any) {
+        this->match(*node.any, segments, index + 1, channel, message, matched);
+    }
+}
+
+bool ChannelPatternTrie::remove(Node& node, const std::vector<std::string>& segments, size_t index, bool& removed) {
+    if (index == segments.size()) {
+        removed = static_cast<bool>(node.exact);
+        node.exact = nullptr;
+    } else if (segments[index] == REST_SEGMENTS) {
+        removed = static_cast<bool>(node.rest);
+        node.rest = nullptr;
+    } else if (segments[index] == ANY_SEGMENT) {
+        if (node.any && this->remove(*node.any, segments, index + 1, removed)) {
+            node.any.reset();
+        }
+    } else {
+        auto child = node.children.find(segments[index]);
+        if (child != node.children.end() && this->remove(*child->second, segments, index + 1, removed)) {
+            node.children.erase(child);
+        }
+    }
+    return node.empty();
+}
+
+} // namespace redis_extended
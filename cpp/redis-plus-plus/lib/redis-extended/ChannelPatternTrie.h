@@ -0,0 +1,74 @@
+#ifndef REDIS_EXTENDED_CHANNEL_PATTERN_TRIE_H
+#define REDIS_EXTENDED_CHANNEL_PATTERN_TRIE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace redis_extended {
+
+// Channel patterns compiled into a trie over dot-separated segments. A pattern segment is a
+// literal, `*` (exactly one segment) or, as the last segment only, `>` (one or more segments):
+// "sensor.*.temp" matches "sensor.a.temp", "sensor.>" matches "sensor.a" and "sensor.a.temp".
+// dispatch() walks the channel's segments once, following at most the literal child and the
+// `*` child at each level, so its cost depends on the channel's depth and the patterns that
+// match, not on how many patterns are registered. Not thread-safe.
+class ChannelPatternTrie {
+public:
+    using Callback = std::function<void(const std::string& channel, const std::string& message)>;
+
+    ChannelPatternTrie();
+    ~ChannelPatternTrie();
+
+    ChannelPatternTrie(const ChannelPatternTrie&) = delete;
+    ChannelPatternTrie& operator=(const ChannelPatternTrie&) = delete;
+
+    // Register a pattern, replacing its callback if present; false for an invalid pattern
+    bool insert(const std::string& pattern, Callback callback);
+
+    // Unregister a pattern; false if it was not registered
+    bool remove(const std::string& pattern);
+
+    bool contains(const std::string& pattern) const;
+    size_t size() const;
+    void clear();
+
+    // Invoke the callback of every pattern matching channel; returns how many were invoked
+    size_t dispatch(const std::string& channel, const std::string& message) const;
+
+    // Non-empty segments, wildcards only as whole segments and `>` only last
+    static bool isValid(const std::string& pattern);
+
+    // Redis glob covering every channel pattern can match: the literal segments before the first
+    // wildcard followed by `*` ("sensor.*.temp" -> "sensor.*"), or the escaped pattern itself
+    // when it has no wildcard
+    static std::string serverPattern(const std::string& pattern);
+
+    // Every glob serverPattern() can produce that matches channel, most specific first: the
+    // channel itself, then each of its segment prefixes followed by `*`, then "*"
+    static std::vector<std::string> coveringServerPatterns(const std::string& channel);
+
+private:
+    struct Node;
+
+    std::unique_ptr<Node> root_; // Empty-prefix node
+    size_t size_;                // Registered patterns
+
+    // Segments of a channel or pattern
+    static std::vector<std::string> split(const std::string& name);
+
+    // Backslash-escape the characters Redis globs treat specially
+    static std::string escapeGlob(const std::string& literal);
+
+    void match(const Node& node, const std::vector<std::string>& segments, size_t index,
+               const std::string& channel, const std::string& message, size_t& matched) const;
+
+    // Remove the pattern below node; returns true when node became empty and can be pruned
+    bool remove(Node& node, const std::vector<std::string>& segments, size_t index, bool& removed);
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_CHANNEL_PATTERN_TRIE_H
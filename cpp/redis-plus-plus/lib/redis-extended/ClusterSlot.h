@@ -0,0 +1,57 @@
+#ifndef REDIS_EXTENDED_CLUSTER_SLOT_H
+#define REDIS_EXTENDED_CLUSTER_SLOT_H
+
+#include <cstdint>
+#include <string>
+
+namespace redis_extended {
+namespace cluster {
+
+// Number of hash slots in a Redis Cluster
+constexpr uint16_t SLOT_COUNT = 16384;
+
+// The part of the key Redis Cluster hashes: the content of the first {...} if it is non-empty,
+// otherwise the whole key
+inline std::string hashTag(const std::string& key) {
+    size_t open = key.find('{');
+    if (open != std::string::npos) {
+        size_t close = key.find('}', open + 1);
+        if (close != std::string::npos && close > open + 1) {
+            return key.substr(open + 1, close - open - 1);
+        }
+    }
+    return key;
+}
+
+// Whether the key already carries a hash tag
+inline bool hasHashTag(const std::string& key) {
+    return hashTag(key).size() != key.size();
+}
+
+// Key name that pins the data key to the slot of its own name, so derived keys such as
+// "lock:" + taggedKey(key) land on the same slot
+inline std::string taggedKey(const std::string& key) {
+    return hasHashTag(key) ? key : "{" + key + "}";
+}
+
+// CRC16-CCITT (XMODEM), the checksum Redis Cluster uses for key slots
+inline uint16_t crc16(const std::string& data) {
+    uint16_t crc = 0;
+    for (unsigned char byte : data) {
+        crc ^= static_cast<uint16_t>(byte) << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Slot owning the key
+inline uint16_t keySlot(const std::string& key) {
+    return crc16(hashTag(key)) % SLOT_COUNT;
+}
+
+} // namespace cluster
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_CLUSTER_SLOT_H
@@ -0,0 +1,146 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include "CsvExporter.h"
+#include "Histogram.h"
+
+namespace redis_extended {
+
+namespace {
+
+std::atomic<uint64_t> nextInstrumentationId(1);
+
+} // namespace
+
+// Histograms of one thread; kept after the thread exits so its samples stay in the aggregate
+struct Instrumentation::Shard {
+    std::mutex mutex;
+    benchmark::Histogram histograms[METRIC_COUNT];
+    std::atomic<bool> closed{false}; // Owning Instrumentation has been destroyed
+};
+
+// Shards of the current thread, one per Instrumentation it has recorded into
+struct Instrumentation::ThreadShards {
+    std::vector<std::pair<uint64_t, std::shared_ptr<Shard>>> shards;
+};
+
+Instrumentation::Timer::Timer(Instrumentation* instrumentation, Metric metric)
+    : instrumentation_(instrumentation), metric_(metric) {
+    if (this->instrumentation_) {
+        this->start_ = std::chrono::steady_clock::now();
+    }
+}
+
+Instrumentation::Timer::~Timer() {
+    if (this->instrumentation_) {
+        this->instrumentation_->record(this->metric_, std::chrono::steady_clock::now() - this->start_);
+    }
+}
+
+Instrumentation::Instrumentation() : id_(nextInstrumentationId++) {
+}
+
+Instrumentation::~Instrumentation() {
+    std::lock_guard<std::mutex> lock(this->shardsMutex_);
+    for (auto& shard : this->shards_) {
+        shard->closed.store(true, std::memory_order_release);
+    }
+}
+
+void Instrumentation::record(Metric metric, std::chrono::nanoseconds elapsed) {
+    Shard& shard = this->threadShard();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.histograms[static_cast<size_t>(metric)].record(elapsed.count());
+}
+
+std::map<std::string, benchmark::Histogram> Instrumentation::aggregate() const {
+    benchmark::Histogram merged[METRIC_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(this->shardsMutex_);
+        for (const auto& shard : this->shards_) {
+            std::lock_guard<std::mutex> shardLock(shard->mutex);
+            for (size_t i = 0; i < METRIC_COUNT; ++i) {
+                merged[i].merge(shard->histograms[i]);
+            }
+        }
+    }
+    std::map<std::string, benchmark::Histogram> result;
+    for (size_t i = 0; i < METRIC_COUNT; ++i) {
+        if (merged[i].count() > 0) {
+            result[metricName(static_cast<Metric>(i))] = std::move(merged[i]);
+        }
+    }
+    return result;
+}
+
+uint64_t Instrumentation::attempts() const {
+    std::map<std::string, benchmark::Histogram> histograms = this->aggregate();
+    uint64_t total = 0;
+    for (Metric metric : {Metric::LOCK_ACQUIRED, Metric::LOCK_FAILED}) {
+        auto it = histograms.find(metricName(metric));
+        if (it != histograms.end()) {
+            total += it->second.count();
+        }
+    }
+    return total;
+}
+
+uint64_t Instrumentation::failures() const {
+    std::map<std::string, benchmark::Histogram> histograms = this->aggregate();
+    auto it = histograms.find(metricName(Metric::LOCK_FAILED));
+    return it != histograms.end() ? it->second.count() : 0;
+}
+
+void Instrumentation::reset() {
+    std::lock_guard<std::mutex> lock(this->shardsMutex_);
+    for (auto& shard : this->shards_) {
+        std::lock_guard<std::mutex> shardLock(shard->mutex);
+        for (size_t i = 0; i < METRIC_COUNT; ++i) {
+            shard->histograms[i] = benchmark::Histogram();
+        }
+    }
+}
+
+bool Instrumentation::exportToCsv(const benchmark::CsvExporter& exporter) const {
+    std::map<std::string, benchmark::Histogram> histograms = this->aggregate();
+    bool statsSuccess = exporter.exportStatsToCsv(histograms);
+    bool histSuccess = exporter.exportHistogramToCsv(histograms);
+    bool percentileSuccess = exporter.exportPercentilesToCsv(histograms);
+    return statsSuccess && histSuccess && percentileSuccess;
+}
+
+const char* Instrumentation::metricName(Metric metric) {
+    switch (metric) {
+        case Metric::LOCK_ACQUIRED: return "LockAcquired";
+        case Metric::LOCK_FAILED: return "LockFailed";
+        case Metric::LOCK_HOLD: return "LockHold";
+        case Metric::READ: return "Read";
+        case Metric::WRITE: return "Write";
+        case Metric::UPDATE: return "Update";
+    }
+    return "Unknown";
+}
+
+Instrumentation::Shard& Instrumentation::threadShard() {
+    thread_local ThreadShards local;
+    for (auto& entry : local.shards) {
+        if (entry.first == this->id_) {
+            return *entry.second;
+        }
+    }
+    // Forget shards of instances that no longer exist before registering a new one
+    local.shards.erase(std::remove_if(local.shards.begin(), local.shards.end(), [](const auto& entry) {
+        return entry.second->closed.load(std::memory_order_acquire);
+    }), local.shards.end());
+
+    auto shard = std::make_shared<Shard>();
+    {
+        std::lock_guard<std::mutex> lock(this->shardsMutex_);
+        this->shards_.push_back(shard);
+    }
+    local.shards.emplace_back(this->id_, shard);
+    return *shard;
+}
+
+} // namespace redis_extended
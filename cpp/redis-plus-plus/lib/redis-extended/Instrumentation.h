@@ -0,0 +1,95 @@
+#ifndef REDIS_EXTENDED_INSTRUMENTATION_H
+#define REDIS_EXTENDED_INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+class CsvExporter;
+class Histogram;
+} // namespace benchmark
+
+namespace redis_extended {
+
+// Contention and latency counters for RedisLeaseLock and RedisKeyManager. Every thread records
+// into its own shard (a lock only the owner and aggregate() ever take, so it is uncontended on
+// the hot path); aggregate() merges the shards into benchmark::Histogram per metric. The names
+// match benchmark operation labels, so CsvExporter writes production and benchmark numbers in
+// the same files and columns. One instance may be shared by any number of managers.
+class Instrumentation {
+public:
+    // What a duration is recorded against
+    enum class Metric : uint8_t {
+        LOCK_ACQUIRED = 0, // Time from the start of an acquisition to success
+        LOCK_FAILED = 1,   // Time spent in an acquisition that gave up
+        LOCK_HOLD = 2,     // Time from acquisition to release
+        READ = 3,
+        WRITE = 4,         // Includes the per-operation lock
+        UPDATE = 5         // Includes the per-operation lock
+    };
+    static constexpr size_t METRIC_COUNT = 6;
+
+    // Records the lifetime of the scope against a metric; does nothing for a null instance
+    class Timer {
+    public:
+        Timer(Instrumentation* instrumentation, Metric metric);
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Instrumentation* instrumentation_;
+        Metric metric_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Constructor
+    Instrumentation();
+
+    // Destructor
+    ~Instrumentation();
+
+    Instrumentation(const Instrumentation&) = delete;
+    Instrumentation& operator=(const Instrumentation&) = delete;
+
+    // Record one duration on the calling thread's shard
+    void record(Metric metric, std::chrono::nanoseconds elapsed);
+
+    // Merge every shard; keys are metricName() of the metrics recorded so far. Callers include
+    // the benchmark library's Histogram.h to use the result.
+    std::map<std::string, benchmark::Histogram> aggregate() const;
+
+    // Acquisition counters derived from the lock histograms
+    uint64_t attempts() const;
+    uint64_t failures() const;
+
+    // Clear every shard
+    void reset();
+
+    // Write stats, histogram and percentile CSVs through the exporter
+    bool exportToCsv(const benchmark::CsvExporter& exporter) const;
+
+    // Operation label of a metric, e.g. "LockAcquired"
+    static const char* metricName(Metric metric);
+
+private:
+    struct Shard;
+    struct ThreadShards;
+
+    const uint64_t id_;                          // Distinguishes instances in the per-thread table
+    mutable std::mutex shardsMutex_;             // Guards shards_
+    std::vector<std::shared_ptr<Shard>> shards_;
+
+    // Shard owned by the calling thread, created on first use
+    Shard& threadShard();
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_INSTRUMENTATION_H
@@ -4,6 +4,25 @@
 namespace redis_extended {
 namespace logging {
 
+const char* levelName(Level level) {
+    switch (level) {
+        case Level::DEBUG: return "DEBUG";
+        case Level::INFO: return "INFO";
+        case Level::WARNING: return "WARNING";
+        case Level::ERROR: return "ERROR";
+        case Level::OFF: return "OFF";
+    }
+    return "INFO";
+}
+
+Level parseLevel(const std::string& name) {
+    if (name == "DEBUG") return Level::DEBUG;
+    if (name == "WARNING") return Level::WARNING;
+    if (name == "ERROR") return Level::ERROR;
+    if (name == "OFF") return Level::OFF;
+    return Level::INFO;
+}
+
 void DefaultLogger::log(const std::string& level, const std::string& message) {
     std::cout << "[" << level << "] " << message << std::endl;
 }
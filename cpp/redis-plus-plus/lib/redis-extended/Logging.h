@@ -1,25 +1,71 @@
 #ifndef REDIS_EXTENDED_LOGGING_H
 #define REDIS_EXTENDED_LOGGING_H
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 namespace redis_extended {
 namespace logging {
 
+// Severity of a log record, in increasing order
+enum class Level : uint8_t {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR,
+    OFF     // Threshold only: disables every record
+};
+
+// Name passed to ILogger::log for a level
+const char* levelName(Level level);
+
+// Parse a level name ("DEBUG", "INFO", "WARNING", "ERROR", "OFF"); unknown names give INFO
+Level parseLevel(const std::string& name);
+
 // Abstract logging interface for modular logging system
 class ILogger {
 public:
     virtual ~ILogger() = default;
     virtual void log(const std::string& level, const std::string& message) = 0;
+
+    // Records below the threshold are discarded before their message is built (default INFO)
+    void setLevel(Level threshold) { this->threshold_.store(threshold, std::memory_order_relaxed); }
+    Level level() const { return this->threshold_.load(std::memory_order_relaxed); }
+    bool isEnabled(Level level) const { return level >= this->threshold_.load(std::memory_order_relaxed); }
+
+    // Deferred formatting: format() is only called when the level is enabled
+    template <typename Formatter>
+    void log(Level level, Formatter&& format) {
+        if (this->isEnabled(level)) {
+            this->log(levelName(level), format());
+        }
+    }
+
+private:
+    std::atomic<Level> threshold_{Level::INFO};
 };
 
 // Default logger implementation for basic console output
 class DefaultLogger : public ILogger {
 public:
+    using ILogger::log;
     void log(const std::string& level, const std::string& message) override;
 };
 
 } // namespace logging
 } // namespace redis_extended
 
+// Log through an ILogger pointer (may be null). The message expression is only evaluated when
+// the logger exists and the level passes its threshold, so disabled statements build no strings.
+// Usage: REDIS_EXTENDED_LOG(logger_, INFO, "Lock acquired for key: " + key_);
+#define REDIS_EXTENDED_LOG(logger, level, message)                                                   \
+    do {                                                                                              \
+        ::redis_extended::logging::ILogger* redis_extended_logger_ = (logger);                       \
+        if (redis_extended_logger_ && redis_extended_logger_->isEnabled(::redis_extended::logging::Level::level)) { \
+            redis_extended_logger_->log(::redis_extended::logging::levelName(                         \
+                ::redis_extended::logging::Level::level), (message));                                 \
+        }                                                                                             \
+    } while (0)
+
 #endif // REDIS_EXTENDED_LOGGING_H
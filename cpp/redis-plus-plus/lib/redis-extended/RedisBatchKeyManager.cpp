@@ -0,0 +1,130 @@
+#include "RedisBatchKeyManager.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace redis_extended {
+
+RedisBatchKeyManager::RedisBatchKeyManager(sw::redis::Redis& redis, const std::vector<std::string>& keys,
+                                           size_t batchSize, uint8_t threadId, logging::ILogger* logger)
+    : redis_(redis), keys_(keys), batchSize_(batchSize > 0 ? batchSize : 1), threadId_(threadId),
+      logger_(logger), tracer_(nullptr) {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Initialized RedisBatchKeyManager for " + std::to_string(keys_.size()) + " keys");
+}
+
+RedisBatchKeyManager::~RedisBatchKeyManager() {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Destroyed RedisBatchKeyManager");
+}
+
+std::vector<sw::redis::OptionalString> RedisBatchKeyManager::readMany() {
+    std::vector<sw::redis::OptionalString> results;
+    results.reserve(keys_.size());
+    for (size_t begin = 0; begin < keys_.size(); begin += batchSize_) {
+        size_t end = std::min(begin + batchSize_, keys_.size());
+        try {
+            redis_.mget(keys_.begin() + begin, keys_.begin() + end, std::back_inserter(results));
+            for (size_t i = begin; i < end; ++i) {
+                trace(benchmark::TraceOp::READ, keys_[i], results[i] ? results[i]->size() : 0);
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading keys " + keys_[begin] + ".." + keys_[end - 1] + ": " + e.what());
+            results.resize(end);
+        }
+    }
+    REDIS_EXTENDED_LOG(logger_, INFO, "Read " + std::to_string(keys_.size()) + " keys");
+    return results;
+}
+
+std::vector<bool> RedisBatchKeyManager::writeMany(const std::vector<std::string>& values) {
+    std::vector<bool> results(keys_.size(), false);
+    if (!checkSize(values, "write")) {
+        return results;
+    }
+    std::vector<std::pair<sw::redis::StringView, sw::redis::StringView>> batch;
+    batch.reserve(std::min(batchSize_, keys_.size()));
+    for (size_t begin = 0; begin < keys_.size(); begin += batchSize_) {
+        size_t end = std::min(begin + batchSize_, keys_.size());
+        batch.clear();
+        for (size_t i = begin; i < end; ++i) {
+            batch.emplace_back(keys_[i], values[i]);
+        }
+        try {
+            redis_.mset(batch.begin(), batch.end());
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = true;
+                trace(benchmark::TraceOp::WRITE, keys_[i], values[i].size());
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error writing keys " + keys_[begin] + ".." + keys_[end - 1] + ": " + e.what());
+        }
+    }
+    REDIS_EXTENDED_LOG(logger_, INFO, "Wrote " + std::to_string(std::count(results.begin(), results.end(), true)) + " of "
+        + std::to_string(keys_.size()) + " keys");
+    return results;
+}
+
+std::vector<bool> RedisBatchKeyManager::updateMany(const std::vector<std::string>& values) {
+    std::vector<bool> results(keys_.size(), false);
+    if (!checkSize(values, "update")) {
+        return results;
+    }
+    for (size_t begin = 0; begin < keys_.size(); begin += batchSize_) {
+        size_t end = std::min(begin + batchSize_, keys_.size());
+        try {
+            // SET ... XX replies OK when the key existed and nil otherwise
+            auto pipe = redis_.pipeline(false);
+            for (size_t i = begin; i < end; ++i) {
+                pipe.set(keys_[i], values[i], std::chrono::milliseconds(0), sw::redis::UpdateType::EXIST);
+            }
+            auto replies = pipe.exec();
+            for (size_t i = begin; i < end; ++i) {
+                results[i] = !sw::redis::reply::is_nil(replies.get(i - begin));
+                trace(benchmark::TraceOp::UPDATE, keys_[i], values[i].size());
+                if (!results[i]) {
+                    REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + keys_[i] + " does not exist for update");
+                }
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error updating keys " + keys_[begin] + ".." + keys_[end - 1] + ": " + e.what());
+        }
+    }
+    REDIS_EXTENDED_LOG(logger_, INFO, "Updated " + std::to_string(std::count(results.begin(), results.end(), true)) + " of "
+        + std::to_string(keys_.size()) + " keys");
+    return results;
+}
+
+const std::vector<std::string>& RedisBatchKeyManager::keys() const {
+    return keys_;
+}
+
+void RedisBatchKeyManager::setBatchSize(size_t batchSize) {
+    batchSize_ = batchSize > 0 ? batchSize : 1;
+}
+
+size_t RedisBatchKeyManager::batchSize() const {
+    return batchSize_;
+}
+
+void RedisBatchKeyManager::setTraceRecorder(TraceRecorder* recorder) {
+    tracer_ = recorder;
+}
+
+bool RedisBatchKeyManager::checkSize(const std::vector<std::string>& values, const std::string& operation) const {
+    if (values.size() != keys_.size()) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Cannot " + operation + " " + std::to_string(keys_.size()) + " keys with "
+            + std::to_string(values.size()) + " values");
+        return false;
+    }
+    return true;
+}
+
+
+void RedisBatchKeyManager::trace(benchmark::TraceOp op, const std::string& key, size_t valueSize) const {
+    if (tracer_) {
+        tracer_->record(op, key, valueSize);
+    }
+}
+
+} // namespace redis_extended
@@ -0,0 +1,67 @@
+#ifndef REDIS_EXTENDED_BATCH_KEY_MANAGER_H
+#define REDIS_EXTENDED_BATCH_KEY_MANAGER_H
+
+#include <string>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+
+// Bulk counterpart of RedisKeyManager: manages a fixed set of keys and touches them with
+// MGET, MSET and pipelined SET XX, batchSize keys per round trip. Results are returned per key,
+// in the order of keys(). Batch operations do not take the per-key leases of RedisKeyManager
+// and do not bump its version counters, so RedisKeyManager::compareAndSet() does not see them.
+class RedisBatchKeyManager {
+public:
+    // Constructor
+    RedisBatchKeyManager(sw::redis::Redis& redis, const std::vector<std::string>& keys,
+                         size_t batchSize = 100, uint8_t threadId = 0,
+                         logging::ILogger* logger = nullptr);
+
+    // Destructor
+    ~RedisBatchKeyManager();
+
+    // Read every key; missing keys (and keys of failed batches) yield an empty OptionalString
+    std::vector<sw::redis::OptionalString> readMany();
+
+    // Write values[i] to keys()[i]; each MSET batch succeeds or fails as a whole
+    std::vector<bool> writeMany(const std::vector<std::string>& values);
+
+    // Overwrite only the keys that already exist; false for missing keys
+    std::vector<bool> updateMany(const std::vector<std::string>& values);
+
+    // Keys managed by this instance
+    const std::vector<std::string>& keys() const;
+
+    // Number of keys sent per round trip
+    void setBatchSize(size_t batchSize);
+    size_t batchSize() const;
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+private:
+    sw::redis::Redis& redis_;       // Reference to Redis connection
+    std::vector<std::string> keys_; // Keys managed by this instance
+    size_t batchSize_;              // Keys per MGET/MSET/pipeline
+    uint8_t threadId_;              // Thread ID for logging purposes
+    logging::ILogger* logger_;      // Logger instance for tracking operations
+    TraceRecorder* tracer_;         // Optional workload trace recorder
+
+    // Helper function to check that one value was supplied per key
+    bool checkSize(const std::vector<std::string>& values, const std::string& operation) const;
+
+    // Helper function to record an operation on one key when tracing is enabled
+    void trace(benchmark::TraceOp op, const std::string& key, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_BATCH_KEY_MANAGER_H
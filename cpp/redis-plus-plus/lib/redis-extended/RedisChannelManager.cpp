@@ -1,82 +1,337 @@
 #include "RedisChannelManager.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include "ValueCodec.h"
+#include "RedisLeaseLock.h"
 
 namespace redis_extended {
 
 RedisChannelManager::RedisChannelManager(sw::redis::Redis& redis, uint8_t threadId, 
                                          logging::ILogger* logger)
-    : redis_(redis), threadId_(threadId), logger_(logger), running_(false) {
-    this->log("INFO", "Initialized RedisChannelManager for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+    : redis_(redis), threadId_(threadId), logger_(logger), tracer_(nullptr), codec_(nullptr), running_(false),
+      wakeChannel_("redis-extended:wake:" + RedisLeaseLock::generateToken()), stopping_(false) {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Initialized RedisChannelManager for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
 }
 
 RedisChannelManager::~RedisChannelManager() {
     this->stopSubscriptions();
-    this->log("INFO", "Destroyed RedisChannelManager for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Destroyed RedisChannelManager for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
 }
 
 bool RedisChannelManager::publish(const std::string& channel, const std::string& jsonMessage) {
     try {
-        this->redis_.publish(channel, jsonMessage);
-        this->log("INFO", "Published message to channel: " + channel);
+        if (this->codec_) {
+            std::string encoded = this->codec_->encode(jsonMessage);
+            this->redis_.publish(channel, encoded);
+            this->trace(benchmark::TraceOp::PUBLISH, channel, encoded.size());
+        } else {
+            this->redis_.publish(channel, jsonMessage);
+            this->trace(benchmark::TraceOp::PUBLISH, channel, jsonMessage.size());
+        }
+        REDIS_EXTENDED_LOG(this->logger_, INFO, "Published message to channel: " + channel);
         return true;
     } catch (const std::exception& e) {
-        this->log("ERROR", "Error publishing to channel " + channel + ": " + e.what());
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error publishing to channel " + channel + ": " + e.what());
         return false;
     }
 }
 
-void RedisChannelManager::subscribe(const std::string& channel, 
-                                    std::function<void(const std::string&)> callback) {
-    if (!this->running_) {
-        this->running_ = true;
-        this->subscriptionThread_ = std::make_unique<std::thread>([this, channel, callback]() {
-            try {
-                sw::redis::Subscriber subscriber = this->redis_.subscriber();
-                subscriber.on_message([&callback](std::string chan, std::string msg) {
-                    callback(msg);
-                });
-                subscriber.subscribe(channel);
-                this->log("INFO", "Subscribed to channel: " + channel);
-                
-                while (this->running_) {
-                    try {
-                        subscriber.consume();
-                    } catch (const sw::redis::TimeoutError& te) {
-                        this->log("INFO", "Timeout waiting for messages on channel " + channel + ": " + te.what());
-                        continue; // Continue the loop to keep subscription active
-                    }
-                }
-            } catch (const std::exception& e) {
-                this->log("ERROR", "Error in subscription to channel " + channel + ": " + e.what());
+void RedisChannelManager::subscribe(const std::string& channel, Callback callback) {
+    this->enqueue({Command::Op::SUBSCRIBE, channel, std::move(callback), PatternCallback()});
+}
+
+void RedisChannelManager::unsubscribe(const std::string& channel) {
+    this->enqueue({Command::Op::UNSUBSCRIBE, channel, Callback(), PatternCallback()});
+}
+
+bool RedisChannelManager::psubscribe(const std::string& pattern, PatternCallback callback) {
+    if (!ChannelPatternTrie::isValid(pattern) || !callback) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Invalid channel pattern: " + pattern);
+        return false;
+    }
+    this->enqueue({Command::Op::PSUBSCRIBE, pattern, Callback(), std::move(callback)});
+    return true;
+}
+
+void RedisChannelManager::punsubscribe(const std::string& pattern) {
+    this->enqueue({Command::Op::PUNSUBSCRIBE, pattern, Callback(), PatternCallback()});
+}
+
+void RedisChannelManager::stopSubscriptions() {
+    // While stopping_ is set no command is queued and no consume thread starts, so the thread
+    // being joined is the only one and nothing else touches the state cleared below. No lock is
+    // held across the join: a callback may still call subscribe() on the consume thread.
+    std::unique_ptr<std::thread> thread;
+    {
+        std::lock_guard<std::mutex> lock(this->commandsMutex_);
+        if (this->stopping_) {
+            return; // Another caller is already stopping
+        }
+        this->stopping_ = true;
+        this->running_ = false;
+        this->commands_.clear();
+        thread = std::move(this->subscriptionThread_);
+    }
+    if (thread && thread->joinable()) {
+        this->wake();
+        thread->join();
+        REDIS_EXTENDED_LOG(this->logger_, INFO, "Stopped all subscription activities for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+    }
+    this->handlers_.clear();
+    this->patterns_.clear();
+    this->serverPatterns_.clear();
+    this->activeServerPatterns_.clear();
+    std::lock_guard<std::mutex> lock(this->commandsMutex_);
+    this->stopping_ = false;
+}
+
+bool RedisChannelManager::ownsDelivery(const std::string& serverPattern, const std::string& channel) const {
+    if (this->activeServerPatterns_.count(serverPattern) == 0) {
+        return false;
+    }
+    if (this->activeServerPatterns_.size() == 1) {
+        return true; // Nothing it could overlap with
+    }
+    for (const std::string& glob : ChannelPatternTrie::coveringServerPatterns(channel)) {
+        if (this->activeServerPatterns_.count(glob) > 0) {
+            return glob == serverPattern;
+        }
+    }
+    return false;
+}
+
+void RedisChannelManager::setTraceRecorder(TraceRecorder* recorder) {
+    this->tracer_ = recorder;
+}
+
+void RedisChannelManager::setValueCodec(const ValueCodec* codec) {
+    this->codec_ = codec;
+}
+
+void RedisChannelManager::enqueue(Command command) {
+    bool subscribes = command.op == Command::Op::SUBSCRIBE || command.op == Command::Op::PSUBSCRIBE;
+    {
+        std::lock_guard<std::mutex> lock(this->commandsMutex_);
+        if (this->stopping_) {
+            // Issued while subscriptions are being stopped (e.g. from a callback); stopping wins
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Dropped subscription change for " + command.channel + " while stopping");
+            return;
+        }
+        this->commands_.push_back(std::move(command));
+        if (!this->running_) {
+            // Removals wait for the next consume thread; only a subscription starts one
+            if (!subscribes) {
+                return;
             }
-        });
-    } else {
-        this->log("WARNING", "Subscription already running for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+            // A previous consume thread may have ended on a connection error; it clears running_
+            // as its last step, so joining here cannot wait on commandsMutex_
+            if (this->subscriptionThread_ && this->subscriptionThread_->joinable()) {
+                this->subscriptionThread_->join();
+            }
+            this->running_ = true;
+            this->subscriptionThread_ = std::make_unique<std::thread>([this]() { this->consumeLoop(); });
+            return;
+        }
     }
+    this->wake();
 }
 
-void RedisChannelManager::unsubscribe(const std::string& channel) {
+void RedisChannelManager::consumeLoop() {
     try {
         sw::redis::Subscriber subscriber = this->redis_.subscriber();
-        subscriber.unsubscribe(channel);
-        this->log("INFO", "Unsubscribed from channel: " + channel);
+        const ValueCodec* codec = this->codec_;
+        auto decode = [this, codec](const std::string& channel, std::string& msg) {
+            if (!codec) {
+                return true;
+            }
+            std::string decoded;
+            if (!codec->decode(msg, decoded)) {
+                REDIS_EXTENDED_LOG(this->logger_, ERROR, "Dropped undecodable message on channel " + channel);
+                return false;
+            }
+            msg.swap(decoded);
+            return true;
+        };
+        subscriber.on_message([this, decode](std::string channel, std::string msg) {
+            auto handler = this->handlers_.find(channel);
+            if (handler == this->handlers_.end()) {
+                return; // Wake-up, or a message that raced an unsubscribe
+            }
+            if (decode(channel, msg)) {
+                handler->second(msg);
+            }
+        });
+        subscriber.on_pmessage([this, decode](std::string pattern, std::string channel, std::string msg) {
+            if (!this->ownsDelivery(pattern, channel)) {
+                return; // Delivered through a more specific glob, or one being removed
+            }
+            if (decode(channel, msg)) {
+                this->patterns_.dispatch(channel, msg);
+            }
+        });
+        subscriber.on_meta([this](sw::redis::Subscriber::MsgType type, sw::redis::OptionalString pattern, long long) {
+            // A glob takes over delivery only once the server confirms it, so no message is lost
+            // or duplicated while a more specific glob is added
+            if (type == sw::redis::Subscriber::MsgType::PSUBSCRIBE && pattern
+                && this->serverPatterns_.count(*pattern) > 0) {
+                this->activeServerPatterns_.insert(*pattern);
+            }
+        });
+
+        // Wait until the wake-up channel is live, so a command queued after the next
+        // applyCommands() always interrupts consume()
+        subscriber.subscribe(this->wakeChannel_);
+        bool listening = false;
+        while (this->running_ && !listening) {
+            try {
+                subscriber.consume();
+                listening = true;
+            } catch (const sw::redis::TimeoutError&) {
+                continue;
+            }
+        }
+
+        // Channels and patterns kept from a consume thread that ended on an error
+        this->activeServerPatterns_.clear();
+        if (!this->handlers_.empty()) {
+            std::vector<std::string> channels;
+            channels.reserve(this->handlers_.size());
+            for (const auto& handler : this->handlers_) {
+                channels.push_back(handler.first);
+            }
+            subscriber.subscribe(channels.begin(), channels.end());
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Restored " + std::to_string(channels.size()) + " subscriptions");
+        }
+        if (!this->serverPatterns_.empty()) {
+            std::vector<std::string> globs;
+            globs.reserve(this->serverPatterns_.size());
+            for (const auto& glob : this->serverPatterns_) {
+                globs.push_back(glob.first);
+            }
+            subscriber.psubscribe(globs.begin(), globs.end());
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Restored " + std::to_string(this->patterns_.size()) + " pattern subscriptions");
+        }
+
+        while (this->running_) {
+            this->applyCommands(subscriber);
+            try {
+                subscriber.consume();
+            } catch (const sw::redis::TimeoutError& te) {
+                REDIS_EXTENDED_LOG(this->logger_, INFO, std::string("Timeout waiting for messages: ") + te.what());
+                continue; // Continue the loop to keep subscriptions active
+            }
+        }
     } catch (const std::exception& e) {
-        this->log("ERROR", "Error unsubscribing from channel " + channel + ": " + e.what());
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, std::string("Error in subscription loop: ") + e.what());
     }
+    // Let the next subscribe() start a new thread; subscriptions are kept so it can restore them
+    std::lock_guard<std::mutex> lock(this->commandsMutex_);
+    this->running_ = false;
 }
 
-void RedisChannelManager::stopSubscriptions() {
-    this->running_ = false;
-    if (this->subscriptionThread_ && this->subscriptionThread_->joinable()) {
-        this->subscriptionThread_->join();
-        this->subscriptionThread_.reset();
-        this->log("INFO", "Stopped all subscription activities for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+void RedisChannelManager::applyCommands(sw::redis::Subscriber& subscriber) {
+    std::vector<Command> commands;
+    {
+        std::lock_guard<std::mutex> lock(this->commandsMutex_);
+        commands.swap(this->commands_);
+    }
+    if (commands.empty()) {
+        return;
+    }
+    // Net effect per channel and pattern, so subscribe/unsubscribe pairs in one batch cancel out
+    std::unordered_map<std::string, bool> channelsBefore;
+    std::unordered_map<std::string, bool> patternsBefore;
+    for (auto& command : commands) {
+        switch (command.op) {
+            case Command::Op::SUBSCRIBE:
+                channelsBefore.emplace(command.channel, this->handlers_.count(command.channel) > 0);
+                this->handlers_[command.channel] = std::move(command.callback);
+                break;
+            case Command::Op::UNSUBSCRIBE:
+                channelsBefore.emplace(command.channel, this->handlers_.count(command.channel) > 0);
+                this->handlers_.erase(command.channel);
+                break;
+            case Command::Op::PSUBSCRIBE:
+                patternsBefore.emplace(command.channel, this->patterns_.contains(command.channel));
+                this->patterns_.insert(command.channel, std::move(command.patternCallback));
+                break;
+            case Command::Op::PUNSUBSCRIBE:
+                patternsBefore.emplace(command.channel, this->patterns_.contains(command.channel));
+                this->patterns_.remove(command.channel);
+                break;
+        }
+    }
+
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    for (const auto& entry : channelsBefore) {
+        bool subscribed = this->handlers_.count(entry.first) > 0;
+        if (subscribed && !entry.second) {
+            added.push_back(entry.first);
+        } else if (!subscribed && entry.second) {
+            removed.push_back(entry.first);
+        }
+    }
+    if (!added.empty()) {
+        subscriber.subscribe(added.begin(), added.end());
+        for (const auto& channel : added) {
+            this->trace(benchmark::TraceOp::SUBSCRIBE, channel, 0);
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Subscribed to channel: " + channel);
+        }
+    }
+    if (!removed.empty()) {
+        subscriber.unsubscribe(removed.begin(), removed.end());
+        for (const auto& channel : removed) {
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Unsubscribed from channel: " + channel);
+        }
+    }
+
+    // Server globs are shared by every pattern with the same literal prefix
+    std::vector<std::string> addedGlobs;
+    std::vector<std::string> removedGlobs;
+    for (const auto& entry : patternsBefore) {
+        bool subscribed = this->patterns_.contains(entry.first);
+        if (subscribed == entry.second) {
+            continue;
+        }
+        std::string glob = ChannelPatternTrie::serverPattern(entry.first);
+        if (subscribed) {
+            if (this->serverPatterns_[glob]++ == 0) {
+                addedGlobs.push_back(glob);
+            }
+            this->trace(benchmark::TraceOp::SUBSCRIBE, entry.first, 0);
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Subscribed to pattern: " + entry.first + " (server pattern " + glob + ")");
+        } else {
+            auto count = this->serverPatterns_.find(glob);
+            if (count != this->serverPatterns_.end() && --count->second == 0) {
+                this->serverPatterns_.erase(count);
+                this->activeServerPatterns_.erase(glob);
+                removedGlobs.push_back(glob);
+            }
+            REDIS_EXTENDED_LOG(this->logger_, INFO, "Unsubscribed from pattern: " + entry.first);
+        }
+    }
+    if (!addedGlobs.empty()) {
+        subscriber.psubscribe(addedGlobs.begin(), addedGlobs.end());
+    }
+    if (!removedGlobs.empty()) {
+        subscriber.punsubscribe(removedGlobs.begin(), removedGlobs.end());
+    }
+}
+
+void RedisChannelManager::wake() {
+    try {
+        this->redis_.publish(this->wakeChannel_, "");
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error waking subscription loop: " + std::string(e.what()));
     }
 }
 
-void RedisChannelManager::log(const std::string& level, const std::string& message) const {
-    if (this->logger_) {
-        this->logger_->log(level, message);
+void RedisChannelManager::trace(benchmark::TraceOp op, const std::string& channel, size_t size) const {
+    if (this->tracer_) {
+        this->tracer_->record(op, channel, size);
     }
 }
 
+
 } // namespace redis_extended
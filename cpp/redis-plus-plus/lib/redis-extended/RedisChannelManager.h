@@ -4,15 +4,43 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <sw/redis++/redis++.h>
 #include "Logging.h"
+#include "ChannelPatternTrie.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
 
 namespace redis_extended {
 
+class TraceRecorder;
+class ValueCodec;
+
+// Publisher and subscriber for any number of channels. All subscriptions share one subscriber
+// connection and one consume thread, started by the first subscription. subscribe(),
+// unsubscribe() and their pattern variants may be called from any thread, callbacks included:
+// they queue a command and wake the consume thread by publishing on a channel private to this
+// manager, and the thread applies the queued commands (batched into one SUBSCRIBE /
+// UNSUBSCRIBE) between messages. Messages are dispatched through a hash table keyed by channel that only the consume thread
+// touches, so dispatch takes no lock. Callbacks run on the consume thread and should not block.
+//
+// Pattern subscriptions are matched locally by a ChannelPatternTrie. The server only sees one
+// coarse PSUBSCRIBE per literal prefix ("sensor.*.temp" and "sensor.>" share "sensor.*"), and
+// each channel is delivered through the most specific of those globs that is confirmed, so
+// overlapping globs never deliver a message twice. A channel matched both by subscribe() and
+// psubscribe() reaches both callbacks, as with Redis.
 class RedisChannelManager {
 public:
+    using Callback = std::function<void(const std::string&)>;
+    using PatternCallback = ChannelPatternTrie::Callback;
+
     // Constructor
     RedisChannelManager(sw::redis::Redis& redis, uint8_t threadId = 0, 
                         logging::ILogger* logger = nullptr);
@@ -23,26 +51,78 @@ public:
     // Publish a JSON message to a specified channel
     bool publish(const std::string& channel, const std::string& jsonMessage);
 
-    // Subscribe to a channel and process incoming messages with a callback
-    // The callback should handle JSON messages
-    void subscribe(const std::string& channel, 
-                   std::function<void(const std::string&)> callback);
+    // Subscribe to a channel and process incoming messages with a callback; subscribing to a
+    // channel again replaces its callback. The callback should handle JSON messages.
+    void subscribe(const std::string& channel, Callback callback);
 
-    // Unsubscribe from a channel
+    // Unsubscribe from a channel; takes effect once the consume thread applies it
     void unsubscribe(const std::string& channel);
 
-    // Stop all subscription activities
+    // Subscribe to every channel matching a dot-separated pattern: `*` matches one segment and a
+    // trailing `>` one or more. Subscribing to a pattern again replaces its callback. Returns
+    // false for a pattern ChannelPatternTrie rejects.
+    bool psubscribe(const std::string& pattern, PatternCallback callback);
+
+    // Unsubscribe from a pattern; takes effect once the consume thread applies it
+    void punsubscribe(const std::string& pattern);
+
+    // Drop every subscription and stop the consume thread. Subscription changes issued while it
+    // runs (e.g. by a callback) are dropped.
     void stopSubscriptions();
 
+    // Capture every publish and subscribe issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    // Compress large messages on publish and decompress them before the subscribe callback
+    // (nullptr sends messages as given). Set it before subscribe(); a message that cannot be
+    // decoded is logged and dropped.
+    void setValueCodec(const ValueCodec* codec);
+
 private:
+    // Subscription change queued for the consume thread
+    struct Command {
+        enum class Op : uint8_t { SUBSCRIBE, UNSUBSCRIBE, PSUBSCRIBE, PUNSUBSCRIBE };
+
+        Op op;
+        std::string channel;             // Channel, or pattern for the P variants
+        Callback callback;               // Set for SUBSCRIBE only
+        PatternCallback patternCallback; // Set for PSUBSCRIBE only
+    };
+
     sw::redis::Redis& redis_; // Reference to Redis connection
     uint8_t threadId_;        // Thread ID for logging purposes
     logging::ILogger* logger_; // Logger instance for tracking operations
+    TraceRecorder* tracer_;    // Optional workload trace recorder
+    const ValueCodec* codec_;  // Optional message compression
     std::atomic<bool> running_; // Flag to control subscription loops
     std::unique_ptr<std::thread> subscriptionThread_; // Thread for handling subscriptions
+    std::string wakeChannel_;   // Private channel used to interrupt consume()
+    std::mutex commandsMutex_;  // Guards commands_, subscriptionThread_ and stopping_
+    bool stopping_;             // stopSubscriptions() is joining and clearing; commands are dropped
+    std::vector<Command> commands_; // Changes not yet applied by the consume thread
+    std::unordered_map<std::string, Callback> handlers_; // Owned by the consume thread
+    ChannelPatternTrie patterns_;                         // Owned by the consume thread
+    std::unordered_map<std::string, size_t> serverPatterns_; // Server glob -> local patterns it covers
+    std::unordered_set<std::string> activeServerPatterns_;   // Globs whose PSUBSCRIBE was confirmed
+
+    // Queue a command, starting the consume thread if needed
+    void enqueue(Command command);
+
+    // Body of the consume thread
+    void consumeLoop();
+
+    // Apply queued commands on the consume thread
+    void applyCommands(sw::redis::Subscriber& subscriber);
+
+    // Interrupt a consume() blocked waiting for messages
+    void wake();
+
+    // Whether a message received through serverPattern should be dispatched: true only for the
+    // most specific confirmed glob covering channel
+    bool ownsDelivery(const std::string& serverPattern, const std::string& channel) const;
 
-    // Helper function to log messages using the provided logger
-    void log(const std::string& level, const std::string& message) const;
+    // Helper function to record a channel operation when tracing is enabled
+    void trace(benchmark::TraceOp op, const std::string& channel, size_t size) const;
 };
 
 } // namespace redis_extended
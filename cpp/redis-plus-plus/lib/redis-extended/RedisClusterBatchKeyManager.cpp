@@ -0,0 +1,166 @@
+#include "RedisClusterBatchKeyManager.h"
+#include "ClusterSlot.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace redis_extended {
+
+RedisClusterBatchKeyManager::RedisClusterBatchKeyManager(sw::redis::RedisCluster& cluster,
+                                                         const std::vector<std::string>& keys, size_t batchSize,
+                                                         size_t parallelism, uint8_t threadId,
+                                                         logging::ILogger* logger)
+    : cluster_(cluster), batchSize_(batchSize > 0 ? batchSize : 1), parallelism_(parallelism > 0 ? parallelism : 1),
+      threadId_(threadId), logger_(logger), tracer_(nullptr) {
+    std::unordered_map<uint16_t, size_t> groupBySlot;
+    keys_.reserve(keys.size());
+    for (const auto& key : keys) {
+        keys_.push_back(cluster::taggedKey(key));
+        uint16_t slot = cluster::keySlot(keys_.back());
+        auto inserted = groupBySlot.emplace(slot, slotGroups_.size());
+        if (inserted.second) {
+            slotGroups_.emplace_back();
+        }
+        slotGroups_[inserted.first->second].push_back(keys_.size() - 1);
+    }
+    REDIS_EXTENDED_LOG(logger_, INFO, "Initialized RedisClusterBatchKeyManager for " + std::to_string(keys_.size()) + " keys in "
+        + std::to_string(slotGroups_.size()) + " slots");
+}
+
+RedisClusterBatchKeyManager::~RedisClusterBatchKeyManager() {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Destroyed RedisClusterBatchKeyManager");
+}
+
+std::vector<sw::redis::OptionalString> RedisClusterBatchKeyManager::readMany() {
+    std::vector<sw::redis::OptionalString> results(keys_.size());
+    forEachBatch([this, &results](const std::vector<size_t>& group, size_t first, size_t last) {
+        std::vector<sw::redis::StringView> batch;
+        for (size_t i = first; i < last; ++i) {
+            batch.emplace_back(keys_[group[i]]);
+        }
+        try {
+            std::vector<sw::redis::OptionalString> values;
+            cluster_.mget(batch.begin(), batch.end(), std::back_inserter(values));
+            for (size_t i = first; i < last && i - first < values.size(); ++i) {
+                results[group[i]] = std::move(values[i - first]);
+                trace(benchmark::TraceOp::READ, keys_[group[i]], results[group[i]] ? results[group[i]]->size() : 0);
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading " + std::to_string(batch.size()) + " keys from slot of "
+                + keys_[group[first]] + ": " + e.what());
+        }
+    });
+    REDIS_EXTENDED_LOG(logger_, INFO, "Read " + std::to_string(keys_.size()) + " keys");
+    return results;
+}
+
+std::vector<bool> RedisClusterBatchKeyManager::writeMany(const std::vector<std::string>& values) {
+    if (!checkSize(values, "write")) {
+        return std::vector<bool>(keys_.size(), false);
+    }
+    // One byte per key: std::vector<bool> packs bits and cannot be written from several threads
+    std::vector<char> stored(keys_.size(), 0);
+    forEachBatch([this, &values, &stored](const std::vector<size_t>& group, size_t first, size_t last) {
+        std::vector<std::pair<sw::redis::StringView, sw::redis::StringView>> batch;
+        for (size_t i = first; i < last; ++i) {
+            batch.emplace_back(keys_[group[i]], values[group[i]]);
+        }
+        try {
+            cluster_.mset(batch.begin(), batch.end());
+            for (size_t i = first; i < last; ++i) {
+                stored[group[i]] = 1;
+                trace(benchmark::TraceOp::WRITE, keys_[group[i]], values[group[i]].size());
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error writing " + std::to_string(batch.size()) + " keys to slot of "
+                + keys_[group[first]] + ": " + e.what());
+        }
+    });
+    REDIS_EXTENDED_LOG(logger_, INFO, "Wrote " + std::to_string(std::count(stored.begin(), stored.end(), 1)) + " of "
+        + std::to_string(keys_.size()) + " keys");
+    return std::vector<bool>(stored.begin(), stored.end());
+}
+
+std::vector<bool> RedisClusterBatchKeyManager::updateMany(const std::vector<std::string>& values) {
+    if (!checkSize(values, "update")) {
+        return std::vector<bool>(keys_.size(), false);
+    }
+    std::vector<char> stored(keys_.size(), 0);
+    forEachBatch([this, &values, &stored](const std::vector<size_t>& group, size_t first, size_t last) {
+        try {
+            // The pipeline is routed by the slot of its first key; every key in the group shares it
+            auto pipe = cluster_.pipeline(keys_[group[first]], false);
+            for (size_t i = first; i < last; ++i) {
+                pipe.set(keys_[group[i]], values[group[i]], std::chrono::milliseconds(0), sw::redis::UpdateType::EXIST);
+            }
+            auto replies = pipe.exec();
+            for (size_t i = first; i < last; ++i) {
+                stored[group[i]] = sw::redis::reply::is_nil(replies.get(i - first)) ? 0 : 1;
+                trace(benchmark::TraceOp::UPDATE, keys_[group[i]], values[group[i]].size());
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error updating keys in slot of " + keys_[group[first]] + ": " + e.what());
+        }
+    });
+    REDIS_EXTENDED_LOG(logger_, INFO, "Updated " + std::to_string(std::count(stored.begin(), stored.end(), 1)) + " of "
+        + std::to_string(keys_.size()) + " keys");
+    return std::vector<bool>(stored.begin(), stored.end());
+}
+
+const std::vector<std::string>& RedisClusterBatchKeyManager::keys() const {
+    return keys_;
+}
+
+size_t RedisClusterBatchKeyManager::slotCount() const {
+    return slotGroups_.size();
+}
+
+void RedisClusterBatchKeyManager::setTraceRecorder(TraceRecorder* recorder) {
+    tracer_ = recorder;
+}
+
+void RedisClusterBatchKeyManager::forEachBatch(
+        const std::function<void(const std::vector<size_t>&, size_t, size_t)>& batch) {
+    std::atomic<size_t> nextGroup(0);
+    auto worker = [this, &batch, &nextGroup]() {
+        for (size_t g = nextGroup++; g < slotGroups_.size(); g = nextGroup++) {
+            const std::vector<size_t>& group = slotGroups_[g];
+            for (size_t first = 0; first < group.size(); first += batchSize_) {
+                batch(group, first, std::min(first + batchSize_, group.size()));
+            }
+        }
+    };
+
+    size_t threads = std::min(parallelism_, slotGroups_.size());
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker(); // The calling thread takes a share of the groups too
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+bool RedisClusterBatchKeyManager::checkSize(const std::vector<std::string>& values, const std::string& operation) const {
+    if (values.size() != keys_.size()) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Cannot " + operation + " " + std::to_string(keys_.size()) + " keys with "
+            + std::to_string(values.size()) + " values");
+        return false;
+    }
+    return true;
+}
+
+
+void RedisClusterBatchKeyManager::trace(benchmark::TraceOp op, const std::string& key, size_t valueSize) const {
+    if (tracer_) {
+        tracer_->record(op, key, valueSize);
+    }
+}
+
+} // namespace redis_extended
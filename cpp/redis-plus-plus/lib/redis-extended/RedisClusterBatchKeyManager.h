@@ -0,0 +1,74 @@
+#ifndef REDIS_EXTENDED_CLUSTER_BATCH_KEY_MANAGER_H
+#define REDIS_EXTENDED_CLUSTER_BATCH_KEY_MANAGER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+
+// RedisBatchKeyManager for Redis Cluster. Keys are tagged like RedisClusterKeyManager does, then
+// grouped by hash slot; each slot group is sent as MGET/MSET/pipelined SET XX batches of at most
+// batchSize keys, and up to parallelism slot groups are processed concurrently. Keys sharing a
+// hash tag (e.g. "{user42}:name", "{user42}:mail") share a slot and therefore a batch. As with
+// RedisBatchKeyManager, writes take no lease and bump no version counter.
+class RedisClusterBatchKeyManager {
+public:
+    // Constructor
+    RedisClusterBatchKeyManager(sw::redis::RedisCluster& cluster, const std::vector<std::string>& keys,
+                                size_t batchSize = 100, size_t parallelism = 4, uint8_t threadId = 0,
+                                logging::ILogger* logger = nullptr);
+
+    // Destructor
+    ~RedisClusterBatchKeyManager();
+
+    // Read every key; missing keys (and keys of failed batches) yield an empty OptionalString
+    std::vector<sw::redis::OptionalString> readMany();
+
+    // Write values[i] to keys()[i]; each MSET batch succeeds or fails as a whole
+    std::vector<bool> writeMany(const std::vector<std::string>& values);
+
+    // Overwrite only the keys that already exist; false for missing keys
+    std::vector<bool> updateMany(const std::vector<std::string>& values);
+
+    // Hash-tagged keys managed by this instance
+    const std::vector<std::string>& keys() const;
+
+    // Number of distinct slots the keys fall into
+    size_t slotCount() const;
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+private:
+    sw::redis::RedisCluster& cluster_; // Reference to the cluster client
+    std::vector<std::string> keys_;    // Hash-tagged keys
+    std::vector<std::vector<size_t>> slotGroups_; // Indexes into keys_, one group per slot
+    size_t batchSize_;                 // Keys per MGET/MSET/pipeline
+    size_t parallelism_;               // Slot groups processed concurrently
+    uint8_t threadId_;                 // Thread ID for logging purposes
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    TraceRecorder* tracer_;            // Optional workload trace recorder
+
+    // Run batch(first, last) over every slot group on up to parallelism threads; first/last index
+    // into the group's key indexes
+    void forEachBatch(const std::function<void(const std::vector<size_t>&, size_t, size_t)>& batch);
+
+    // Helper function to check that one value was supplied per key
+    bool checkSize(const std::vector<std::string>& values, const std::string& operation) const;
+
+    // Helper function to record an operation on one key when tracing is enabled
+    void trace(benchmark::TraceOp op, const std::string& key, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_CLUSTER_BATCH_KEY_MANAGER_H
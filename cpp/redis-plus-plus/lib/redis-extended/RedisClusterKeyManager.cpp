@@ -0,0 +1,159 @@
+#include "RedisClusterKeyManager.h"
+#include "RedisScriptRegistry.h"
+#include "ClusterSlot.h"
+#include "RedisLeaseLock.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+
+namespace redis_extended {
+
+namespace {
+
+// KEYS: data, lock. ARGV: value, our token (empty when not holding the lock), require existing (0/1).
+// Returns -1 when another client holds the lock, 0 when an update finds no key, 1 after writing.
+const RedisScript GUARDED_SET_SCRIPT("guarded_set",
+    "local owner = redis.call('get', KEYS[2]) "
+    "if owner and owner ~= ARGV[2] then return -1 end "
+    "if ARGV[3] == '1' and redis.call('exists', KEYS[1]) == 0 then return 0 end "
+    "redis.call('set', KEYS[1], ARGV[1]) "
+    "return 1");
+
+} // namespace
+
+RedisClusterKeyManager::RedisClusterKeyManager(sw::redis::RedisCluster& cluster, const std::string& key,
+                                               uint8_t threadId, logging::ILogger* logger,
+                                               std::chrono::milliseconds lockTtl)
+    : cluster_(cluster), key_(cluster::taggedKey(key)), lockKey_("lock:" + key_), wakeKey_(lockKey_ + ":wake"),
+      threadId_(threadId), logger_(logger), tracer_(nullptr), lockTtl_(lockTtl) {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Initialized RedisClusterKeyManager for key: " + key_ + " (slot "
+        + std::to_string(cluster::keySlot(key_)) + ")");
+}
+
+RedisClusterKeyManager::~RedisClusterKeyManager() {
+    if (!token_.empty()) {
+        unlock();
+    }
+    REDIS_EXTENDED_LOG(logger_, INFO, "Destroyed RedisClusterKeyManager for key: " + key_);
+}
+
+bool RedisClusterKeyManager::tryLock() {
+    if (!token_.empty()) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Lock already held for key: " + key_);
+        return false;
+    }
+    try {
+        std::string token = RedisLeaseLock::generateToken();
+        bool acquired = cluster_.set(lockKey_, token, lockTtl_, sw::redis::UpdateType::NOT_EXIST);
+        trace(benchmark::TraceOp::LOCK);
+        if (acquired) {
+            token_ = token;
+            REDIS_EXTENDED_LOG(logger_, INFO, "Lock acquired for key: " + key_);
+        } else {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Failed to acquire lock for key: " + key_);
+        }
+        return acquired;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error trying to lock key " + key_ + ": " + e.what());
+        return false;
+    }
+}
+
+void RedisClusterKeyManager::unlock() {
+    std::string token;
+    token.swap(token_);
+    if (token.empty()) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Lock for key " + key_ + " was not held by this manager at release");
+        return;
+    }
+    try {
+        long long released = RedisLeaseLock::releaseScript().call<long long>(cluster_, {lockKey_, wakeKey_},
+                                                      {token, std::to_string(lockTtl_.count())});
+        trace(benchmark::TraceOp::UNLOCK);
+        if (released == 1) {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Lock released for key: " + key_);
+        } else {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Lock for key " + key_ + " expired before release");
+        }
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error releasing lock for key " + key_ + ": " + e.what());
+    }
+}
+
+bool RedisClusterKeyManager::isLocked() {
+    try {
+        return cluster_.exists(lockKey_);
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error checking lock status for key " + key_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisClusterKeyManager::holdsLock() const {
+    return !token_.empty();
+}
+
+bool RedisClusterKeyManager::write(const std::string& value) {
+    return guardedSet(value, false);
+}
+
+bool RedisClusterKeyManager::update(const std::string& newValue) {
+    return guardedSet(newValue, true);
+}
+
+std::string RedisClusterKeyManager::read() {
+    try {
+        auto value = cluster_.get(key_);
+        trace(benchmark::TraceOp::READ, value ? value->size() : 0);
+        if (value) {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully read value from key: " + key_);
+            return *value;
+        }
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
+        return "";
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
+        return "";
+    }
+}
+
+const std::string& RedisClusterKeyManager::key() const {
+    return key_;
+}
+
+void RedisClusterKeyManager::setTraceRecorder(TraceRecorder* recorder) {
+    tracer_ = recorder;
+}
+
+void RedisClusterKeyManager::registerScripts(RedisScriptRegistry& registry) {
+    registry.add(GUARDED_SET_SCRIPT.name(), GUARDED_SET_SCRIPT.body());
+    registry.add(RedisLeaseLock::releaseScript().name(), RedisLeaseLock::releaseScript().body());
+}
+
+bool RedisClusterKeyManager::guardedSet(const std::string& value, bool requireExisting) {
+    try {
+        long long result = GUARDED_SET_SCRIPT.call<long long>(cluster_, {key_, lockKey_},
+                                                    {value, token_, requireExisting ? "1" : "0"});
+        trace(requireExisting ? benchmark::TraceOp::UPDATE : benchmark::TraceOp::WRITE, value.size());
+        if (result == 1) {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully stored value for key: " + key_);
+            return true;
+        } else if (result == 0) {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for update");
+        } else {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot write to key " + key_ + ": Lock held by another client");
+        }
+        return false;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error writing to key " + key_ + ": " + e.what());
+        return false;
+    }
+}
+
+
+void RedisClusterKeyManager::trace(benchmark::TraceOp op, size_t valueSize) const {
+    if (tracer_) {
+        tracer_->record(op, key_, valueSize);
+    }
+}
+
+} // namespace redis_extended
@@ -0,0 +1,74 @@
+#ifndef REDIS_EXTENDED_CLUSTER_KEY_MANAGER_H
+#define REDIS_EXTENDED_CLUSTER_KEY_MANAGER_H
+
+#include <chrono>
+#include <string>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+class RedisScriptRegistry;
+
+// RedisKeyManager for Redis Cluster. The data key is hash-tagged ("{key}" unless the key already
+// carries a tag) and the lock is "lock:" + the tagged key, so both live on the same slot. That
+// lets write() and update() check the lock and store the value in one script on one shard
+// instead of lock, write and unlock round trips. The lease lock itself matches RedisLeaseLock
+// (token owner, PX ttl, token-checked release) without background renewal.
+class RedisClusterKeyManager {
+public:
+    // Constructor
+    RedisClusterKeyManager(sw::redis::RedisCluster& cluster, const std::string& key, uint8_t threadId = 0,
+                           logging::ILogger* logger = nullptr,
+                           std::chrono::milliseconds lockTtl = std::chrono::seconds(30));
+
+    // Destructor; releases the lock only if this instance holds it
+    ~RedisClusterKeyManager();
+
+    // Locking methods
+    bool tryLock();
+    void unlock();
+    bool isLocked();
+    bool holdsLock() const;
+
+    // Data manipulation methods; writes fail while another client holds the lock
+    bool write(const std::string& value);
+    bool update(const std::string& newValue);
+    std::string read();
+
+    // Hash-tagged name under which the value is stored
+    const std::string& key() const;
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    // Add the scripts this manager runs to registry. A cluster learns scripts per shard, so
+    // preload() has to be run against each master's sw::redis::Redis.
+    static void registerScripts(RedisScriptRegistry& registry);
+
+private:
+    sw::redis::RedisCluster& cluster_; // Reference to the cluster client
+    std::string key_;                  // Hash-tagged data key
+    std::string lockKey_;              // Lock on the same slot as key_
+    std::string wakeKey_;              // Release signal shared with RedisLeaseLock waiters
+    uint8_t threadId_;                 // Thread ID for logging purposes
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    TraceRecorder* tracer_;            // Optional workload trace recorder
+    std::chrono::milliseconds lockTtl_; // Lease duration
+    std::string token_;                // Owner token of the held lease, empty when not held
+
+    // Lock-checked SET in one script; requireExisting turns it into an update
+    bool guardedSet(const std::string& value, bool requireExisting);
+
+    // Helper function to record an operation on the managed key when tracing is enabled
+    void trace(benchmark::TraceOp op, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_CLUSTER_KEY_MANAGER_H
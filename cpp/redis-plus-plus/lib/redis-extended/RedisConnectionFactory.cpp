@@ -0,0 +1,237 @@
+#include "RedisConnectionFactory.h"
+#include <algorithm>
+#include "RedisBatchKeyManager.h"
+#include "RedisChannelManager.h"
+#include "RedisKeyManager.h"
+
+namespace redis_extended {
+
+namespace {
+
+// Numeric field of an INFO section ("name:value\r\n"), -1 when absent
+long long infoField(const std::string& info, const std::string& name) {
+    std::string prefix = name + ":";
+    size_t pos = 0;
+    while ((pos = info.find(prefix, pos)) != std::string::npos) {
+        if (pos == 0 || info[pos - 1] == '\n') {
+            try {
+                return std::stoll(info.substr(pos + prefix.size()));
+            } catch (const std::exception&) {
+                return -1;
+            }
+        }
+        pos += prefix.size();
+    }
+    return -1;
+}
+
+} // namespace
+
+struct RedisConnectionFactory::Endpoint {
+    std::string name;
+    PoolSettings settings;
+    std::unique_ptr<sw::redis::Redis> redis;
+    size_t warmed = 0;
+    uint64_t managers = 0;
+    uint64_t samples = 0;
+    uint64_t waiters = 0;
+    uint64_t checkoutFailures = 0;
+    std::chrono::microseconds lastWait{0};
+    std::chrono::microseconds maxWait{0};
+    std::chrono::microseconds totalWait{0};
+    long long connectedClients = -1;
+    double connectionsPerSecond = 0.0;
+    long long connectionsReceived = -1;                     // Server counter at the previous sample
+    std::chrono::steady_clock::time_point sampledAt;        // Time of the previous sample
+};
+
+RedisConnectionFactory::RedisConnectionFactory(logging::ILogger* logger)
+    : RedisConnectionFactory(PoolSettings(), logger) {
+}
+
+RedisConnectionFactory::RedisConnectionFactory(const PoolSettings& defaults, logging::ILogger* logger)
+    : defaults_(defaults), logger_(logger) {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Initialized RedisConnectionFactory with default pool size " + std::to_string(this->defaults_.size));
+}
+
+RedisConnectionFactory::~RedisConnectionFactory() {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Destroyed RedisConnectionFactory with " + std::to_string(this->endpoints_.size()) + " pools");
+}
+
+sw::redis::Redis& RedisConnectionFactory::pool(const sw::redis::ConnectionOptions& options) {
+    return *this->open(options, this->defaults_).redis;
+}
+
+sw::redis::Redis& RedisConnectionFactory::pool(const sw::redis::ConnectionOptions& options, const PoolSettings& settings) {
+    return *this->open(options, settings).redis;
+}
+
+std::unique_ptr<RedisKeyManager> RedisConnectionFactory::keyManager(const sw::redis::ConnectionOptions& options,
+                                                                    const std::string& key, uint8_t threadId,
+                                                                    std::chrono::milliseconds lockTtl) {
+    Endpoint& endpoint = this->open(options, this->defaults_);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        ++endpoint.managers;
+    }
+    return std::make_unique<RedisKeyManager>(*endpoint.redis, key, threadId, this->logger_, lockTtl);
+}
+
+std::unique_ptr<RedisBatchKeyManager> RedisConnectionFactory::batchKeyManager(const sw::redis::ConnectionOptions& options,
+                                                                              const std::vector<std::string>& keys,
+                                                                              size_t batchSize, uint8_t threadId) {
+    Endpoint& endpoint = this->open(options, this->defaults_);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        ++endpoint.managers;
+    }
+    return std::make_unique<RedisBatchKeyManager>(*endpoint.redis, keys, batchSize, threadId, this->logger_);
+}
+
+std::unique_ptr<RedisChannelManager> RedisConnectionFactory::channelManager(const sw::redis::ConnectionOptions& options,
+                                                                            uint8_t threadId) {
+    Endpoint& endpoint = this->open(options, this->defaults_);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        ++endpoint.managers;
+    }
+    return std::make_unique<RedisChannelManager>(*endpoint.redis, threadId, this->logger_);
+}
+
+RedisConnectionFactory::PoolMetrics RedisConnectionFactory::sample(const sw::redis::ConnectionOptions& options) {
+    Endpoint& endpoint = this->open(options, this->defaults_);
+
+    // Checkout probe: a non-owning pipeline borrows a pooled connection for its lifetime
+    bool failed = false;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        sw::redis::Pipeline probe = endpoint.redis->pipeline(false);
+        (void)probe;
+    } catch (const std::exception& e) {
+        failed = true;
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Pool checkout failed for " + endpoint.name + ": " + e.what());
+    }
+    auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    // Server view; also goes through the pool
+    long long connectedClients = -1;
+    long long connectionsReceived = -1;
+    try {
+        connectedClients = infoField(endpoint.redis->info("clients"), "connected_clients");
+        connectionsReceived = infoField(endpoint.redis->info("stats"), "total_connections_received");
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "INFO failed for " + endpoint.name + ": " + e.what());
+    }
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    ++endpoint.samples;
+    if (failed) {
+        ++endpoint.checkoutFailures;
+    } else {
+        if (wait >= endpoint.settings.waitThreshold) {
+            ++endpoint.waiters;
+        }
+        endpoint.lastWait = wait;
+        endpoint.maxWait = std::max(endpoint.maxWait, wait);
+        endpoint.totalWait += wait;
+    }
+    if (connectedClients >= 0) {
+        endpoint.connectedClients = connectedClients;
+    }
+    if (connectionsReceived >= 0) {
+        if (endpoint.connectionsReceived >= 0) {
+            double seconds = std::chrono::duration<double>(now - endpoint.sampledAt).count();
+            if (seconds > 0.0) {
+                endpoint.connectionsPerSecond = (connectionsReceived - endpoint.connectionsReceived) / seconds;
+            }
+        }
+        endpoint.connectionsReceived = connectionsReceived;
+        endpoint.sampledAt = now;
+    }
+
+    return RedisConnectionFactory::snapshot(endpoint);
+}
+
+std::vector<RedisConnectionFactory::PoolMetrics> RedisConnectionFactory::metrics() const {
+    std::vector<PoolMetrics> result;
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (const auto& entry : this->endpoints_) {
+        result.push_back(RedisConnectionFactory::snapshot(*entry.second));
+    }
+    return result;
+}
+
+RedisConnectionFactory::PoolMetrics RedisConnectionFactory::snapshot(const Endpoint& endpoint) {
+    PoolMetrics metrics;
+    metrics.endpoint = endpoint.name;
+    metrics.poolSize = endpoint.settings.size;
+    metrics.warmed = endpoint.warmed;
+    metrics.managers = endpoint.managers;
+    metrics.samples = endpoint.samples;
+    metrics.waiters = endpoint.waiters;
+    metrics.checkoutFailures = endpoint.checkoutFailures;
+    metrics.lastWait = endpoint.lastWait;
+    metrics.maxWait = endpoint.maxWait;
+    uint64_t measured = endpoint.samples - endpoint.checkoutFailures;
+    metrics.meanWait = measured > 0 ? endpoint.totalWait / static_cast<std::chrono::microseconds::rep>(measured) : std::chrono::microseconds(0);
+    metrics.connectedClients = endpoint.connectedClients;
+    metrics.connectionsPerSecond = endpoint.connectionsPerSecond;
+    return metrics;
+}
+
+std::string RedisConnectionFactory::endpoint(const sw::redis::ConnectionOptions& options) {
+    std::string address = options.type == sw::redis::ConnectionType::UNIX
+        ? "unix:" + options.path
+        : options.host + ":" + std::to_string(options.port);
+    return address + "/" + std::to_string(options.db);
+}
+
+RedisConnectionFactory::Endpoint& RedisConnectionFactory::open(const sw::redis::ConnectionOptions& options,
+                                                               const PoolSettings& settings) {
+    std::string name = RedisConnectionFactory::endpoint(options);
+    // Held across creation and warm-up so concurrent first users do not race to build two pools
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->endpoints_.find(name);
+    if (it != this->endpoints_.end()) {
+        return *it->second;
+    }
+
+    sw::redis::ConnectionPoolOptions poolOptions;
+    poolOptions.size = std::max<size_t>(settings.size, 1);
+    poolOptions.wait_timeout = settings.waitTimeout;
+    poolOptions.connection_lifetime = settings.connectionLifetime;
+    poolOptions.connection_idle_time = settings.connectionIdleTime;
+
+    auto endpoint = std::make_unique<Endpoint>();
+    endpoint->name = name;
+    endpoint->settings = settings;
+    endpoint->settings.size = poolOptions.size;
+    endpoint->redis = std::make_unique<sw::redis::Redis>(options, poolOptions);
+    endpoint->warmed = this->warm(*endpoint->redis, std::min(settings.warmConnections, poolOptions.size));
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Opened pool for " + name + " with " + std::to_string(poolOptions.size)
+        + " connections, " + std::to_string(endpoint->warmed) + " warmed");
+
+    Endpoint& result = *endpoint;
+    this->endpoints_.emplace(name, std::move(endpoint));
+    return result;
+}
+
+size_t RedisConnectionFactory::warm(sw::redis::Redis& redis, size_t count) {
+    // The pool connects lazily and reuses idle connections, so sequential commands would only
+    // ever open one; holding `count` non-owning pipelines at once forces distinct connections
+    std::vector<sw::redis::Pipeline> held;
+    held.reserve(count);
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            sw::redis::Pipeline pipeline = redis.pipeline(false);
+            pipeline.command("PING").exec();
+            held.push_back(std::move(pipeline));
+        }
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Warm-up stopped after " + std::to_string(held.size()) + " connections: " + e.what());
+    }
+    return held.size();
+}
+
+} // namespace redis_extended
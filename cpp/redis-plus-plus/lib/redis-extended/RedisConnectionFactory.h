@@ -0,0 +1,114 @@
+#ifndef REDIS_EXTENDED_CONNECTION_FACTORY_H
+#define REDIS_EXTENDED_CONNECTION_FACTORY_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace redis_extended {
+
+class RedisKeyManager;
+class RedisBatchKeyManager;
+class RedisChannelManager;
+
+// Owns one pooled sw::redis::Redis per endpoint and builds managers bound to it, so threads
+// share a sized, pre-connected pool instead of each opening its own connection. The factory
+// must outlive every manager it creates.
+//
+// redis++ does not expose its pool internals (queue depth, wait times, connection churn), so
+// metrics are sampled from outside:
+//   - pool wait: time to check a connection out of the pool with a non-owning pipeline, taken
+//     by sample(); includes connecting when the pool had to open a new connection
+//   - waiters: samples whose checkout took at least waitThreshold, i.e. the pool was exhausted
+//   - connection creation rate: server-side total_connections_received between two samples,
+//     which covers every client of the server, not only this pool
+class RedisConnectionFactory {
+public:
+    // Pool configuration for one endpoint
+    struct PoolSettings {
+        size_t size = 8;                                            // Maximum connections
+        // Checkout timeout (0 waits forever). Blocking lock waiters hold a connection in BLPOP for
+        // their whole wait, so a finite timeout turns lock contention into checkout errors unless
+        // size leaves room for every thread that may wait at once.
+        std::chrono::milliseconds waitTimeout{0};
+        std::chrono::milliseconds connectionLifetime{0};            // Recycle after this age (0 disables)
+        std::chrono::milliseconds connectionIdleTime{0};            // Recycle after this idle time (0 disables)
+        size_t warmConnections = 8;                                 // Connections opened on pool creation
+        std::chrono::microseconds waitThreshold{1000};              // Checkout counted as a wait from here
+    };
+
+    // Sampled view of one endpoint
+    struct PoolMetrics {
+        std::string endpoint;
+        size_t poolSize = 0;
+        size_t warmed = 0;                          // Connections opened during warm-up
+        uint64_t managers = 0;                      // Managers handed out for this endpoint
+        uint64_t samples = 0;                       // Checkout probes taken by sample()
+        uint64_t waiters = 0;                       // Probes that waited at least waitThreshold
+        uint64_t checkoutFailures = 0;              // Probes that hit waitTimeout or failed to connect
+        std::chrono::microseconds lastWait{0};
+        std::chrono::microseconds maxWait{0};
+        std::chrono::microseconds meanWait{0};
+        long long connectedClients = -1;            // Server INFO clients, -1 if unavailable
+        double connectionsPerSecond = 0.0;          // Server-wide connection creation rate
+    };
+
+    // Constructors; defaults apply to endpoints opened without explicit settings
+    explicit RedisConnectionFactory(logging::ILogger* logger = nullptr);
+    explicit RedisConnectionFactory(const PoolSettings& defaults, logging::ILogger* logger = nullptr);
+
+    // Destructor
+    ~RedisConnectionFactory();
+
+    RedisConnectionFactory(const RedisConnectionFactory&) = delete;
+    RedisConnectionFactory& operator=(const RedisConnectionFactory&) = delete;
+
+    // Pool for an endpoint, created and warmed on first use; later settings are ignored
+    sw::redis::Redis& pool(const sw::redis::ConnectionOptions& options);
+    sw::redis::Redis& pool(const sw::redis::ConnectionOptions& options, const PoolSettings& settings);
+
+    // Managers bound to the endpoint's pool
+    std::unique_ptr<RedisKeyManager> keyManager(const sw::redis::ConnectionOptions& options,
+                                                const std::string& key, uint8_t threadId = 0,
+                                                std::chrono::milliseconds lockTtl = std::chrono::seconds(30));
+    std::unique_ptr<RedisBatchKeyManager> batchKeyManager(const sw::redis::ConnectionOptions& options,
+                                                          const std::vector<std::string>& keys,
+                                                          size_t batchSize = 100, uint8_t threadId = 0);
+    std::unique_ptr<RedisChannelManager> channelManager(const sw::redis::ConnectionOptions& options,
+                                                        uint8_t threadId = 0);
+
+    // Probe the endpoint's pool and server, then return its metrics
+    PoolMetrics sample(const sw::redis::ConnectionOptions& options);
+
+    // Last metrics of every endpoint without probing
+    std::vector<PoolMetrics> metrics() const;
+
+    // Identity of an endpoint: host:port/db or unix socket path/db
+    static std::string endpoint(const sw::redis::ConnectionOptions& options);
+
+private:
+    struct Endpoint;
+
+    PoolSettings defaults_;                                // Settings for pool(options)
+    logging::ILogger* logger_;                             // Logger instance for tracking operations
+    mutable std::mutex mutex_;                             // Guards endpoints_ and their metrics
+    std::map<std::string, std::unique_ptr<Endpoint>> endpoints_;
+
+    // Find or create the endpoint entry
+    Endpoint& open(const sw::redis::ConnectionOptions& options, const PoolSettings& settings);
+
+    // Metrics of an endpoint; called with mutex_ held
+    static PoolMetrics snapshot(const Endpoint& endpoint);
+
+    // Check out `count` connections at once so the pool opens them now
+    size_t warm(sw::redis::Redis& redis, size_t count);
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_CONNECTION_FACTORY_H
@@ -0,0 +1,229 @@
+#include "RedisHashValueManager.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include <iterator>
+
+namespace redis_extended {
+
+bool RedisHashValueManager::Diff::empty() const {
+    return this->changed.empty() && this->removed.empty();
+}
+
+RedisHashValueManager::RedisHashValueManager(sw::redis::Redis& redis, const std::string& key, uint8_t threadId,
+                                             logging::ILogger* logger)
+    : redis_(redis), key_(key), threadId_(threadId), logger_(logger), tracer_(nullptr), hasBaseline_(false) {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Initialized RedisHashValueManager for key: " + this->key_);
+}
+
+RedisHashValueManager::~RedisHashValueManager() {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Destroyed RedisHashValueManager for key: " + this->key_);
+}
+
+bool RedisHashValueManager::write(const Fields& fields) {
+    try {
+        // Piped: MULTI, the commands and EXEC go out together in one round trip on a pooled connection
+        auto tx = this->redis_.transaction(true, false);
+        tx.del(this->key_);
+        if (!fields.empty()) {
+            tx.hset(this->key_, fields.begin(), fields.end());
+        }
+        tx.exec();
+        size_t bytes = 0;
+        for (const auto& field : fields) {
+            bytes += field.first.size() + field.second.size();
+        }
+        this->trace(benchmark::TraceOp::WRITE, bytes);
+        this->baseline_ = fields;
+        this->hasBaseline_ = true;
+        REDIS_EXTENDED_LOG(this->logger_, INFO, "Wrote " + std::to_string(fields.size()) + " fields to key: " + this->key_);
+        return true;
+    } catch (const std::exception& e) {
+        this->resetBaseline();
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error writing key " + this->key_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisHashValueManager::update(const Fields& fields) {
+    ++this->stats_.updates;
+    if (!this->hasBaseline_) {
+        this->read();
+        if (!this->hasBaseline_) {
+            return false;
+        }
+    }
+    Diff changes = diff(this->baseline_, fields);
+    size_t skipped = 0;
+    for (const auto& field : fields) {
+        if (changes.changed.find(field.first) == changes.changed.end()) {
+            skipped += field.first.size() + field.second.size();
+        }
+    }
+    this->stats_.bytesSkipped += skipped;
+    if (changes.empty()) {
+        ++this->stats_.unchanged;
+        REDIS_EXTENDED_LOG(this->logger_, DEBUG, "No field of key " + this->key_ + " changed");
+        return true;
+    }
+    try {
+        this->apply(changes);
+        this->baseline_ = fields;
+        REDIS_EXTENDED_LOG(this->logger_, INFO, "Updated " + std::to_string(changes.changed.size()) + " and removed "
+            + std::to_string(changes.removed.size()) + " fields of key: " + this->key_);
+        return true;
+    } catch (const std::exception& e) {
+        this->resetBaseline();
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error updating key " + this->key_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisHashValueManager::updateFields(const Fields& changed) {
+    if (changed.empty()) {
+        return true;
+    }
+    try {
+        Diff patch;
+        patch.changed = changed;
+        this->apply(patch);
+        if (this->hasBaseline_) {
+            for (const auto& field : changed) {
+                this->baseline_[field.first] = field.second;
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        this->resetBaseline();
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error updating fields of key " + this->key_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisHashValueManager::removeFields(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        return true;
+    }
+    try {
+        Diff patch;
+        patch.removed = names;
+        this->apply(patch);
+        if (this->hasBaseline_) {
+            for (const auto& name : names) {
+                this->baseline_.erase(name);
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        this->resetBaseline();
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error removing fields of key " + this->key_ + ": " + e.what());
+        return false;
+    }
+}
+
+RedisHashValueManager::Fields RedisHashValueManager::read() {
+    try {
+        Fields fields;
+        this->redis_.hgetall(this->key_, std::inserter(fields, fields.end()));
+        size_t bytes = 0;
+        for (const auto& field : fields) {
+            bytes += field.first.size() + field.second.size();
+        }
+        this->trace(benchmark::TraceOp::READ, bytes);
+        this->baseline_ = fields;
+        this->hasBaseline_ = true;
+        return fields;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error reading key " + this->key_ + ": " + e.what());
+        return Fields();
+    }
+}
+
+RedisHashValueManager::Fields RedisHashValueManager::readFields(const std::vector<std::string>& names) {
+    Fields fields;
+    if (names.empty()) {
+        return fields;
+    }
+    try {
+        std::vector<sw::redis::OptionalString> values;
+        values.reserve(names.size());
+        this->redis_.hmget(this->key_, names.begin(), names.end(), std::back_inserter(values));
+        size_t bytes = 0;
+        for (size_t i = 0; i < names.size() && i < values.size(); ++i) {
+            if (values[i]) {
+                bytes += values[i]->size();
+                fields.emplace(names[i], std::move(*values[i]));
+            }
+        }
+        this->trace(benchmark::TraceOp::READ, bytes);
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error reading fields of key " + this->key_ + ": " + e.what());
+    }
+    return fields;
+}
+
+const RedisHashValueManager::Fields& RedisHashValueManager::baseline() const {
+    return this->baseline_;
+}
+
+bool RedisHashValueManager::hasBaseline() const {
+    return this->hasBaseline_;
+}
+
+void RedisHashValueManager::resetBaseline() {
+    this->baseline_.clear();
+    this->hasBaseline_ = false;
+}
+
+RedisHashValueManager::Stats RedisHashValueManager::stats() const {
+    return this->stats_;
+}
+
+RedisHashValueManager::Diff RedisHashValueManager::diff(const Fields& before, const Fields& after) {
+    Diff result;
+    for (const auto& field : after) {
+        auto it = before.find(field.first);
+        if (it == before.end() || it->second != field.second) {
+            result.changed.insert(field);
+        }
+    }
+    for (const auto& field : before) {
+        if (after.find(field.first) == after.end()) {
+            result.removed.push_back(field.first);
+        }
+    }
+    return result;
+}
+
+void RedisHashValueManager::setTraceRecorder(TraceRecorder* recorder) {
+    this->tracer_ = recorder;
+}
+
+void RedisHashValueManager::apply(const Diff& diff) {
+    auto tx = this->redis_.transaction(true, false);
+    size_t bytes = 0;
+    if (!diff.changed.empty()) {
+        tx.hset(this->key_, diff.changed.begin(), diff.changed.end());
+        for (const auto& field : diff.changed) {
+            bytes += field.first.size() + field.second.size();
+        }
+    }
+    if (!diff.removed.empty()) {
+        tx.hdel(this->key_, diff.removed.begin(), diff.removed.end());
+        for (const auto& name : diff.removed) {
+            bytes += name.size();
+        }
+    }
+    tx.exec();
+    this->stats_.fieldsSet += diff.changed.size();
+    this->stats_.fieldsRemoved += diff.removed.size();
+    this->stats_.bytesSent += bytes;
+    this->trace(benchmark::TraceOp::UPDATE, bytes);
+}
+
+void RedisHashValueManager::trace(benchmark::TraceOp op, size_t valueSize) const {
+    if (this->tracer_) {
+        this->tracer_->record(op, this->key_, valueSize);
+    }
+}
+
+} // namespace redis_extended
@@ -0,0 +1,109 @@
+#ifndef REDIS_EXTENDED_HASH_VALUE_MANAGER_H
+#define REDIS_EXTENDED_HASH_VALUE_MANAGER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+
+// Structured value stored as a Redis hash, one field per top-level member, instead of a single
+// serialised string. update() diffs the new fields against the last state this manager wrote or
+// read and sends only the difference (HSET of changed fields, HDEL of removed ones) in one
+// MULTI/EXEC, so the bytes on the wire follow the size of the change rather than the document.
+// readFields() fetches just the requested fields with HMGET.
+//
+// The diff baseline is local: a change made by another client is not seen until read() refreshes
+// it, and until then update() may skip a field that now differs on the server. Writers sharing
+// a key should read() before updating or serialise with a lock. See RedisJsonHash.h for the
+// mapping from a flat JSON object to Fields.
+class RedisHashValueManager {
+public:
+    using Fields = std::unordered_map<std::string, std::string>;
+
+    // Field-level difference between two states
+    struct Diff {
+        Fields changed;                    // Fields added or modified
+        std::vector<std::string> removed;  // Fields no longer present
+
+        bool empty() const;
+    };
+
+    // Traffic counters since construction
+    struct Stats {
+        uint64_t updates = 0;       // update() calls
+        uint64_t unchanged = 0;     // update() calls with nothing to send
+        uint64_t fieldsSet = 0;     // Fields sent with HSET
+        uint64_t fieldsRemoved = 0; // Fields sent with HDEL
+        uint64_t bytesSent = 0;     // Field names and values sent by update()
+        uint64_t bytesSkipped = 0;  // Bytes of unchanged fields update() did not resend
+    };
+
+    // Constructor
+    RedisHashValueManager(sw::redis::Redis& redis, const std::string& key, uint8_t threadId = 0,
+                          logging::ILogger* logger = nullptr);
+
+    // Destructor
+    ~RedisHashValueManager();
+
+    // Replace the whole value (DEL + HSET in one transaction) and make it the baseline
+    bool write(const Fields& fields);
+
+    // Send only the difference to the baseline; loads the baseline first if none is known
+    bool update(const Fields& fields);
+
+    // Set the given fields without touching the others
+    bool updateFields(const Fields& changed);
+
+    // Remove the given fields
+    bool removeFields(const std::vector<std::string>& names);
+
+    // Whole value with HGETALL; refreshes the baseline
+    Fields read();
+
+    // Only the requested fields with HMGET; fields missing on the server are left out
+    Fields readFields(const std::vector<std::string>& names);
+
+    // State update() diffs against
+    const Fields& baseline() const;
+    bool hasBaseline() const;
+
+    // Forget the baseline so the next update() reloads it from the server
+    void resetBaseline();
+
+    Stats stats() const;
+
+    // Difference that turns `before` into `after`
+    static Diff diff(const Fields& before, const Fields& after);
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+private:
+    sw::redis::Redis& redis_;   // Reference to Redis connection
+    std::string key_;           // Hash holding the value
+    uint8_t threadId_;          // Thread ID for logging purposes
+    logging::ILogger* logger_;  // Logger instance for tracking operations
+    TraceRecorder* tracer_;     // Optional workload trace recorder
+    Fields baseline_;           // Last state written or read
+    bool hasBaseline_;          // Whether baseline_ reflects the server
+    Stats stats_;
+
+    // Send a diff in one MULTI/EXEC
+    void apply(const Diff& diff);
+
+    // Helper function to record an operation on the managed key when tracing is enabled
+    void trace(benchmark::TraceOp op, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_HASH_VALUE_MANAGER_H
@@ -0,0 +1,42 @@
+#ifndef REDIS_EXTENDED_JSON_HASH_H
+#define REDIS_EXTENDED_JSON_HASH_H
+
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "RedisHashValueManager.h"
+
+namespace redis_extended {
+
+// Mapping between a JSON object and RedisHashValueManager::Fields: each top-level member becomes
+// one hash field holding the member's serialised JSON, so changing one member rewrites one
+// field. Nested objects stay whole inside their field. Header-only, so the library itself does
+// not depend on nlohmann/json; include it from code that already links it.
+namespace json_hash {
+
+// Fields of a JSON object; throws std::invalid_argument if object is not an object
+inline RedisHashValueManager::Fields toFields(const nlohmann::json& object) {
+    if (!object.is_object()) {
+        throw std::invalid_argument("RedisJsonHash expects a JSON object");
+    }
+    RedisHashValueManager::Fields fields;
+    fields.reserve(object.size());
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        fields.emplace(it.key(), it.value().dump());
+    }
+    return fields;
+}
+
+// JSON object rebuilt from fields; throws nlohmann::json::parse_error on a field that is not JSON
+inline nlohmann::json fromFields(const RedisHashValueManager::Fields& fields) {
+    nlohmann::json object = nlohmann::json::object();
+    for (const auto& field : fields) {
+        object[field.first] = nlohmann::json::parse(field.second);
+    }
+    return object;
+}
+
+} // namespace json_hash
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_JSON_HASH_H
@@ -1,115 +1,444 @@
 #include "RedisKeyManager.h"
+#include "RedisScriptRegistry.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include "RedisNearCache.h"
+#include "Instrumentation.h"
+#include "ValueCodec.h"
+#include <iterator>
+#include <vector>
 
 namespace redis_extended {
 
+namespace {
+
+// KEYS: data, lock, version. ARGV: new value.
+// Returns -1 when locked, 0 when the key is missing, 1 after writing (and bumping the version).
+const RedisScript ATOMIC_UPDATE_SCRIPT("atomic_update",
+    "if redis.call('exists', KEYS[2]) == 1 then return -1 end "
+    "if redis.call('exists', KEYS[1]) == 0 then return 0 end "
+    "redis.call('set', KEYS[1], ARGV[1]) "
+    "redis.call('incr', KEYS[3]) "
+    "return 1");
+
+// KEYS: data, lock, version. ARGV: expected version, new value, caller's lease token ('' if none).
+// Returns the new version, or -1 when someone else holds the lock or the stored version differs
+// from the expected one.
+const RedisScript COMPARE_AND_SET_SCRIPT("compare_and_set",
+    "local owner = redis.call('get', KEYS[2]) "
+    "if owner and owner ~= ARGV[3] then return -1 end "
+    "local current = tonumber(redis.call('get', KEYS[3]) or '0') "
+    "if current ~= tonumber(ARGV[1]) then return -1 end "
+    "redis.call('set', KEYS[1], ARGV[2]) "
+    "return redis.call('incr', KEYS[3])");
+
+// KEYS: data, fence, version, lock. ARGV: fencing token, new value, '1' to require an existing
+// key, owner token. Returns -1 when the lease is no longer ours (expired, or a newer one has been
+// issued), 0 when the key is missing, 1 after writing (and bumping the version, so a
+// compare-and-set based on an older read fails). Checking the owner token as well as the fence
+// also rejects a holder whose lease expired while a lock-free writer (atomic update or
+// compare-and-set, which never touch the fence) wrote in between.
+const RedisScript FENCED_SET_SCRIPT("fenced_set",
+    "if redis.call('get', KEYS[4]) ~= ARGV[4] then return -1 end "
+    "if tonumber(redis.call('get', KEYS[2]) or '0') ~= tonumber(ARGV[1]) then return -1 end "
+    "if ARGV[3] == '1' and redis.call('exists', KEYS[1]) == 0 then return 0 end "
+    "redis.call('set', KEYS[1], ARGV[2]) "
+    "redis.call('incr', KEYS[3]) "
+    "return 1");
+
+} // namespace
+
 RedisKeyManager::RedisKeyManager(sw::redis::Redis& redis, const std::string& key, uint8_t threadId, 
-                                 logging::ILogger* logger)
-    : redis_(redis), key_(key), lockKey_("lock:" + key), threadId_(threadId), logger_(logger) {
-    log("INFO", "Initialized RedisKeyManager for key: " + key_);
+                                 logging::ILogger* logger, std::chrono::milliseconds lockTtl)
+    : redis_(redis), key_(key), lockKey_("lock:" + key), versionKey_("version:" + key), threadId_(threadId), logger_(logger), tracer_(nullptr), cache_(nullptr), instrumentation_(nullptr), codec_(nullptr),
+      lock_(redis, lockKey_, lockTtl, true, logger), explicitLock_(false), updateMode_(UpdateMode::LOCKED) {
+    REDIS_EXTENDED_LOG(logger_, INFO, "Initialized RedisKeyManager for key: " + key_);
 }
 
 RedisKeyManager::~RedisKeyManager() {
-    // Ensure the lock is released if held
-    if (isLocked()) {
+    // Release the lock only if this instance holds it; another client's lock is left alone
+    if (lock_.isHeld()) {
         unlock();
     }
-    log("INFO", "Destroyed RedisKeyManager for key: " + key_);
+    REDIS_EXTENDED_LOG(logger_, INFO, "Destroyed RedisKeyManager for key: " + key_);
 }
 
 bool RedisKeyManager::tryLock() {
+    bool acquired = acquireLease(true);
+    explicitLock_ = explicitLock_ || acquired;
+    return acquired;
+}
+
+bool RedisKeyManager::acquireLease(bool autoRenew) {
     try {
-        // Attempt to acquire the lock using SETNX
-        bool acquired = redis_.setnx(lockKey_, "locked");
+        // Attempt to acquire the lease using SET NX PX with a random owner token
+        bool acquired = lock_.tryLock(autoRenew);
+        trace(benchmark::TraceOp::LOCK);
         if (acquired) {
-            log("INFO", "Lock acquired for key: " + key_);
+            REDIS_EXTENDED_LOG(logger_, INFO, "Lock acquired for key: " + key_);
         } else {
-            log("WARNING", "Failed to acquire lock for key: " + key_);
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Failed to acquire lock for key: " + key_);
         }
         return acquired;
     } catch (const std::exception& e) {
-        log("ERROR", "Error trying to lock key " + key_ + ": " + e.what());
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error trying to lock key " + key_ + ": " + e.what());
         return false;
     }
 }
 
+bool RedisKeyManager::lock(std::chrono::milliseconds timeout) {
+    bool acquired = lock_.lock(timeout);
+    explicitLock_ = explicitLock_ || acquired;
+    trace(benchmark::TraceOp::LOCK);
+    if (acquired) {
+        REDIS_EXTENDED_LOG(logger_, INFO, "Lock acquired for key: " + key_);
+    } else {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Timed out acquiring lock for key: " + key_);
+    }
+    return acquired;
+}
+
 void RedisKeyManager::unlock() {
-    try {
-        redis_.del(lockKey_);
-        log("INFO", "Lock released for key: " + key_);
-    } catch (const std::exception& e) {
-        log("ERROR", "Error releasing lock for key " + key_ + ": " + e.what());
+    explicitLock_ = false;
+    releaseLease();
+}
+
+void RedisKeyManager::releaseLease() {
+    // Token-checked release: a lease that expired and was taken over is not deleted
+    if (lock_.unlock()) {
+        REDIS_EXTENDED_LOG(logger_, INFO, "Lock released for key: " + key_);
+    } else {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Lock for key " + key_ + " was not held by this manager at release");
     }
+    trace(benchmark::TraceOp::UNLOCK);
 }
 
 bool RedisKeyManager::isLocked() {
     try {
         return redis_.exists(lockKey_);
     } catch (const std::exception& e) {
-        log("ERROR", "Error checking lock status for key " + key_ + ": " + e.what());
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error checking lock status for key " + key_ + ": " + e.what());
         return false;
     }
 }
 
+bool RedisKeyManager::holdsLock() const {
+    return lock_.isHeld();
+}
+
+long long RedisKeyManager::fencingToken() const {
+    return lock_.fencingToken();
+}
+
+bool RedisKeyManager::leaseLost() const {
+    return explicitLock_ && !lock_.isHeld();
+}
+
 bool RedisKeyManager::write(const std::string& value) {
-    if (!tryLock()) {
-        log("WARNING", "Cannot write to key " + key_ + ": Lock not acquired");
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::WRITE);
+    // Compress before taking the lock so the lease is not held during encoding
+    std::string buffer;
+    const std::string& stored = encode(value, buffer);
+    if (leaseLost()) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot write to key " + key_ + ": lease lost");
+        return false;
+    }
+    bool ownLease = lock_.isHeld();
+    // A lease held for one request needs no renewal thread
+    if (!ownLease && !acquireLease(false)) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot write to key " + key_ + ": Lock not acquired");
         return false;
     }
     try {
-        redis_.set(key_, value);
-        log("INFO", "Successfully wrote value to key: " + key_);
-        unlock();
+        long long result = fencedSet(stored, false);
+        // A stale token means the lease is gone, so drop it even if it was taken explicitly; an
+        // explicit lock stays in effect, so later writes fail until unlock()
+        if (!ownLease || result < 0) releaseLease();
+        if (result != 1) {
+            return false;
+        }
+        trace(benchmark::TraceOp::WRITE, stored.size());
+        if (cache_) cache_->invalidate(key_);
+        REDIS_EXTENDED_LOG(logger_, INFO, "Successfully wrote value to key: " + key_);
         return true;
     } catch (const std::exception& e) {
-        log("ERROR", "Error writing to key " + key_ + ": " + e.what());
-        unlock();
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error writing to key " + key_ + ": " + e.what());
+        if (!ownLease) releaseLease();
         return false;
     }
 }
 
 bool RedisKeyManager::update(const std::string& newValue) {
-    if (!tryLock()) {
-        log("WARNING", "Cannot update key " + key_ + ": Lock not acquired");
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::UPDATE);
+    std::string buffer;
+    const std::string& stored = encode(newValue, buffer);
+    if (leaseLost()) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot update key " + key_ + ": lease lost");
+        return false;
+    }
+    if (updateMode_ == UpdateMode::ATOMIC) {
+        return updateAtomic(stored);
+    }
+    bool ownLease = lock_.isHeld();
+    // A lease held for one request needs no renewal thread
+    if (!ownLease && !acquireLease(false)) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot update key " + key_ + ": Lock not acquired");
         return false;
     }
     try {
-        if (redis_.exists(key_)) {
-            redis_.set(key_, newValue);
-            log("INFO", "Successfully updated value for key: " + key_);
-            unlock();
+        // Existence check, fencing check and write in one request
+        long long result = fencedSet(stored, true);
+        if (!ownLease || result < 0) releaseLease();
+        if (result == 1) {
+            trace(benchmark::TraceOp::UPDATE, stored.size());
+            if (cache_) cache_->invalidate(key_);
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully updated value for key: " + key_);
             return true;
-        } else {
-            log("WARNING", "Key " + key_ + " does not exist for update");
-            unlock();
-            return false;
+        } else if (result == 0) {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for update");
         }
+        return false;
     } catch (const std::exception& e) {
-        log("ERROR", "Error updating key " + key_ + ": " + e.what());
-        unlock();
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error updating key " + key_ + ": " + e.what());
+        if (!ownLease) releaseLease();
         return false;
     }
 }
 
 std::string RedisKeyManager::read() {
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::READ);
     try {
-        auto value = redis_.get(key_);
+        auto value = cache_ ? cache_->get(key_) : redis_.get(key_);
+        trace(benchmark::TraceOp::READ, value ? value->size() : 0);
         if (value) {
-            log("INFO", "Successfully read value from key: " + key_);
-            return *value;
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully read value from key: " + key_);
+            if (codec_) {
+                std::string decoded;
+                return decode(value->data(), value->size(), decoded) ? std::move(decoded) : std::string();
+            }
+            return std::move(*value);
         } else {
-            log("WARNING", "Key " + key_ + " does not exist for read");
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
             return "";
         }
     } catch (const std::exception& e) {
-        log("ERROR", "Error reading from key " + key_ + ": " + e.what());
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
         return "";
     }
 }
 
-void RedisKeyManager::log(const std::string& level, const std::string& message) const {
-    if (logger_) {
-        logger_->log(level, message);
+bool RedisKeyManager::read(std::string& out) {
+    if (cache_) {
+        Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::READ);
+        try {
+            auto value = cache_->get(key_);
+            trace(benchmark::TraceOp::READ, value ? value->size() : 0);
+            if (!value) {
+                REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
+                return false;
+            }
+            return decode(value->data(), value->size(), out);
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
+            return false;
+        }
+    }
+    ValueView value = readView();
+    if (!value) {
+        return false;
+    }
+    // Single copy (or decompression) from the reply into storage the caller already owns
+    return decode(value.data(), value.size(), out);
+}
+
+RedisKeyManager::ValueView RedisKeyManager::readView() {
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::READ);
+    try {
+        ValueView value(redis_.command("GET", key_));
+        trace(benchmark::TraceOp::READ, value.size());
+        if (value) {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully read value from key: " + key_);
+        } else {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
+        }
+        return value;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading from key " + key_ + ": " + e.what());
+        return ValueView();
+    }
+}
+
+RedisKeyManager::ValueView::ValueView(sw::redis::ReplyUPtr reply) : reply_(std::move(reply)) {
+    if (reply_ && reply_->type != REDIS_REPLY_STRING) {
+        reply_.reset(); // Nil reply: the key does not exist
+    }
+}
+
+bool RedisKeyManager::ValueView::found() const {
+    return static_cast<bool>(reply_);
+}
+
+sw::redis::StringView RedisKeyManager::ValueView::view() const {
+    return reply_ ? sw::redis::StringView(reply_->str, reply_->len) : sw::redis::StringView();
+}
+
+const char* RedisKeyManager::ValueView::data() const {
+    return reply_ ? reply_->str : nullptr;
+}
+
+size_t RedisKeyManager::ValueView::size() const {
+    return reply_ ? reply_->len : 0;
+}
+
+void RedisKeyManager::setUpdateMode(UpdateMode mode) {
+    updateMode_ = mode;
+}
+
+long long RedisKeyManager::fencedSet(const std::string& value, bool mustExist) {
+    long long fencingToken = lock_.fencingToken();
+    long long result = FENCED_SET_SCRIPT.call<long long>(redis_, {key_, lock_.fenceKey(), versionKey_, lockKey_},
+                                                         {std::to_string(fencingToken), value, mustExist ? "1" : "0", lock_.token()});
+    if (result < 0) {
+        REDIS_EXTENDED_LOG(logger_, WARNING, "Rejected write to key " + key_ + ": lease with fencing token "
+            + std::to_string(fencingToken) + " expired or was taken over");
+    }
+    return result;
+}
+
+bool RedisKeyManager::updateAtomic(const std::string& newValue) {
+    try {
+        if (lock_.isHeld()) {
+            // We own the lease, so a fenced SET is already exclusive
+            long long result = fencedSet(newValue, true);
+            if (result < 0) {
+                releaseLease();
+                return false;
+            }
+            trace(benchmark::TraceOp::UPDATE, newValue.size());
+            if (cache_) cache_->invalidate(key_);
+            if (result == 0) {
+                REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for update");
+            }
+            return result == 1;
+        }
+        long long result = ATOMIC_UPDATE_SCRIPT.call<long long>(redis_, {key_, lockKey_, versionKey_}, {newValue});
+        trace(benchmark::TraceOp::UPDATE, newValue.size());
+        if (cache_) cache_->invalidate(key_);
+        if (result == 1) {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully updated value for key: " + key_);
+            return true;
+        } else if (result == 0) {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for update");
+        } else {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Cannot update key " + key_ + ": Lock held by another client");
+        }
+        return false;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error updating key " + key_ + ": " + e.what());
+        return false;
+    }
+}
+
+long long RedisKeyManager::compareAndSet(long long expectedVersion, const std::string& newValue) {
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::UPDATE);
+    try {
+        std::string buffer;
+        const std::string& stored = encode(newValue, buffer);
+        long long version = COMPARE_AND_SET_SCRIPT.call<long long>(redis_, {key_, lockKey_, versionKey_},
+                                                   {std::to_string(expectedVersion), stored, lock_.isHeld() ? lock_.token() : ""});
+        trace(benchmark::TraceOp::UPDATE, stored.size());
+        if (cache_) cache_->invalidate(key_);
+        if (version < 0) {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Version conflict or lock held updating key " + key_ + " (expected version " + std::to_string(expectedVersion) + ")");
+        } else {
+            REDIS_EXTENDED_LOG(logger_, INFO, "Successfully updated key " + key_ + " to version " + std::to_string(version));
+        }
+        return version;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error in compare-and-set for key " + key_ + ": " + e.what());
+        return -1;
+    }
+}
+
+bool RedisKeyManager::readVersioned(std::string& value, long long& version) {
+    Instrumentation::Timer timer(instrumentation_, Instrumentation::Metric::READ);
+    try {
+        std::vector<sw::redis::OptionalString> values;
+        std::initializer_list<std::string> keys = {key_, versionKey_};
+        redis_.mget(keys.begin(), keys.end(), std::back_inserter(values));
+        if (values.size() != 2 || !values[0]) {
+            REDIS_EXTENDED_LOG(logger_, WARNING, "Key " + key_ + " does not exist for read");
+            return false;
+        }
+        trace(benchmark::TraceOp::READ, values[0]->size());
+        if (codec_) {
+            if (!decode(values[0]->data(), values[0]->size(), value)) {
+                return false;
+            }
+        } else {
+            value = std::move(*values[0]);
+        }
+        version = values[1] ? std::stoll(*values[1]) : 0;
+        return true;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Error reading versioned key " + key_ + ": " + e.what());
+        return false;
+    }
+}
+
+void RedisKeyManager::setNearCache(RedisNearCache* cache) {
+    cache_ = cache;
+}
+
+void RedisKeyManager::setInstrumentation(Instrumentation* instrumentation) {
+    instrumentation_ = instrumentation;
+    lock_.setInstrumentation(instrumentation);
+}
+
+void RedisKeyManager::setValueCodec(const ValueCodec* codec) {
+    codec_ = codec;
+}
+
+void RedisKeyManager::setTraceRecorder(TraceRecorder* recorder) {
+    tracer_ = recorder;
+}
+
+const RedisScript& RedisKeyManager::fencedSetScript() {
+    return FENCED_SET_SCRIPT;
+}
+
+void RedisKeyManager::registerScripts(RedisScriptRegistry& registry) {
+    for (const RedisScript* script : {&ATOMIC_UPDATE_SCRIPT, &COMPARE_AND_SET_SCRIPT, &FENCED_SET_SCRIPT}) {
+        registry.add(script->name(), script->body());
+    }
+    RedisLeaseLock::registerScripts(registry);
+}
+
+const std::string& RedisKeyManager::encode(const std::string& value, std::string& buffer) const {
+    if (!codec_) {
+        return value;
+    }
+    buffer = codec_->encode(value);
+    return buffer;
+}
+
+bool RedisKeyManager::decode(const char* data, size_t size, std::string& out) const {
+    if (!codec_) {
+        out.assign(data, size);
+        return true;
+    }
+    if (!codec_->decode(data, size, out)) {
+        REDIS_EXTENDED_LOG(logger_, ERROR, "Cannot decode value of key " + key_);
+        return false;
     }
+    return true;
 }
 
+void RedisKeyManager::trace(benchmark::TraceOp op, size_t valueSize) const {
+    if (tracer_) {
+        tracer_->record(op, key_, valueSize);
+    }
+}
+
+
 } // namespace redis_extended
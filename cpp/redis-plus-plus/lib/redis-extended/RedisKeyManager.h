@@ -1,40 +1,166 @@
 #ifndef REDIS_EXTENDED_KEY_MANAGER_H
 #define REDIS_EXTENDED_KEY_MANAGER_H
 
+#include <chrono>
 #include <string>
 #include <sw/redis++/redis++.h>
 #include "Logging.h"
+#include "RedisLeaseLock.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
 
 namespace redis_extended {
 
+class TraceRecorder;
+class RedisNearCache;
+class Instrumentation;
+class ValueCodec;
+class RedisScript;
+class RedisScriptRegistry;
+
 class RedisKeyManager {
 public:
-    // Constructor
+    // How update() reaches the server
+    enum class UpdateMode {
+        LOCKED,  // Acquire the lease, fenced write, release (three round trips, one when the lease is held)
+        ATOMIC   // One server-side script: write only if the key exists and nobody holds the lock
+    };
+
+    // Value read without copying: owns the raw GET reply, views stay valid while it lives
+    class ValueView {
+    public:
+        ValueView() = default;
+        explicit ValueView(sw::redis::ReplyUPtr reply);
+
+        // False on a miss (or failed read); an empty value is found with size() == 0
+        bool found() const;
+        explicit operator bool() const { return found(); }
+
+        sw::redis::StringView view() const;
+        const char* data() const;
+        size_t size() const;
+
+    private:
+        sw::redis::ReplyUPtr reply_; // Bulk string reply, or null on a miss
+    };
+
+    // Constructor; the lock is a lease of lockTtl. A lease taken through lock()/tryLock() is renewed
+    // in the background while held; the per-operation lease of write()/update() is not.
     RedisKeyManager(sw::redis::Redis& redis, const std::string& key, uint8_t threadId = 0, 
-                    logging::ILogger* logger = nullptr);
+                    logging::ILogger* logger = nullptr,
+                    std::chrono::milliseconds lockTtl = std::chrono::seconds(30));
 
-    // Destructor
+    // Destructor; releases the lock only if this instance holds it
     ~RedisKeyManager();
 
     // Locking methods
     bool tryLock();
+    bool lock(std::chrono::milliseconds timeout); // Wait for a release instead of polling
     void unlock();
     bool isLocked();
+    bool holdsLock() const;
 
-    // Data manipulation methods
+    // Fencing token of the current or last lease, for fencing writes to other systems
+    long long fencingToken() const;
+
+    // Data manipulation methods. Writes under the lease are fenced: the SET runs server-side only
+    // while the lock still carries this lease's owner token and its fencing token is still the
+    // newest, so a writer whose lease expired is rejected in the same request, whether the lock
+    // was taken over or a lock-free writer went in while it was free. With a lease already held through
+    // lock()/tryLock() no per-operation lock is taken; once that lease is lost, writes fail until
+    // unlock() (or a new lock()/tryLock()) is called, even though the lock may be free again.
     bool write(const std::string& value);
     bool update(const std::string& newValue);
     std::string read();
 
+    // Read into a caller-owned buffer, reusing its capacity. Returns false on a miss (out is left
+    // untouched), so a missing key and an empty value are told apart, and on a stored value the
+    // value codec cannot decode.
+    bool read(std::string& out);
+
+    // Read without copying the value out of the reply. The view holds the stored bytes: with a
+    // value codec set, a compressed value must be passed through ValueCodec::decode().
+    ValueView readView();
+
+    // Select the strategy used by update() (default LOCKED)
+    void setUpdateMode(UpdateMode mode);
+
+    // Write newValue only if the version counter still equals expectedVersion and nobody else
+    // holds the lock, in one round trip. Writes through RedisKeyManager and AsyncRedisKeyManager
+    // bump the counter, so any of them since the versioned read fails the check. Writes through
+    // RedisBatchKeyManager, RedisClusterBatchKeyManager and RedisWriteCoalescer do not, and are
+    // invisible to it: do not mix them with compareAndSet() on the same keys. Returns the new version, or -1 if another writer got there
+    // first or the lock is held.
+    long long compareAndSet(long long expectedVersion, const std::string& newValue);
+
+    // Read the value and its version counter in one round trip; returns false if the key is missing
+    bool readVersioned(std::string& value, long long& version);
+
+    // Capture every Redis operation issued by this manager (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    // Serve read() from a shared client-side cache (nullptr reads from Redis every time)
+    void setNearCache(RedisNearCache* cache);
+
+    // Record lock contention and operation latency, including the lease lock (nullptr disables)
+    void setInstrumentation(Instrumentation* instrumentation);
+
+    // Compress large values on write and decompress on read (nullptr stores values as given).
+    // Values written without a codec are still read correctly once one is set.
+    void setValueCodec(const ValueCodec* codec);
+
+    // Add the scripts this manager runs (its lease scripts included) to registry, so
+    // RedisScriptRegistry::preload() can SCRIPT LOAD them at startup
+    static void registerScripts(RedisScriptRegistry& registry);
+
+    // Owner- and fence-checked SET that bumps the version counter; KEYS: data, fence, version,
+    // lock. ARGV: fencing token, value, '1' to require an existing key, owner token. Returns 1
+    // after writing, 0 when the key is missing, -1 when the lease is gone. Shared with managers
+    // writing the same keys so compareAndSet() sees their writes.
+    static const RedisScript& fencedSetScript();
+
 private:
     sw::redis::Redis& redis_; // Reference to Redis connection
     std::string key_;         // Key managed by this instance
     std::string lockKey_;     // Key used for locking
+    std::string versionKey_;  // Counter bumped by every write
     uint8_t threadId_;        // Thread ID for logging purposes
     logging::ILogger* logger_; // Logger instance for tracking operations
+    TraceRecorder* tracer_;   // Optional workload trace recorder
+    RedisNearCache* cache_;   // Optional near cache for read()
+    Instrumentation* instrumentation_; // Optional contention and latency counters
+    const ValueCodec* codec_; // Optional value compression
+    RedisLeaseLock lock_;     // Token-owned lease on lockKey_
+    bool explicitLock_;       // lock()/tryLock() succeeded and unlock() has not been called since
+    UpdateMode updateMode_;   // Strategy used by update()
+
+    // SET conditional on the lease's owner and fencing tokens (and on the key existing when
+    // mustExist). Returns 1 after writing, 0 when the key is missing, -1 when the lease is gone.
+    long long fencedSet(const std::string& value, bool mustExist);
+
+    // Acquire the lease once, with background renewal only if autoRenew
+    bool acquireLease(bool autoRenew);
+
+    // Token-checked release shared by unlock() and the per-operation lease
+    void releaseLease();
+
+    // An explicit lock is in effect but its lease was lost (expired or taken over); writes must
+    // fail instead of quietly taking a new lease
+    bool leaseLost() const;
+
+    // Single round-trip conditional update used in UpdateMode::ATOMIC
+    bool updateAtomic(const std::string& newValue);
+
+    // Value as stored: value itself without a codec, otherwise its encoding in buffer
+    const std::string& encode(const std::string& value, std::string& buffer) const;
+
+    // Stored bytes back to the value; logs and returns false on a frame that cannot be decoded
+    bool decode(const char* data, size_t size, std::string& out) const;
 
-    // Helper function to log messages using the provided logger
-    void log(const std::string& level, const std::string& message) const;
+    // Helper function to record an operation on the managed key when tracing is enabled
+    void trace(benchmark::TraceOp op, size_t valueSize = 0) const;
 };
 
 } // namespace redis_extended
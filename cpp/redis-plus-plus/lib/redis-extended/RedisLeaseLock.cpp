@@ -0,0 +1,284 @@
+#include "RedisLeaseLock.h"
+#include "RedisScriptRegistry.h"
+#include "Instrumentation.h"
+#include <algorithm>
+#include <random>
+
+namespace redis_extended {
+
+namespace {
+
+// Delete the lock only if it still carries our token, then leave one wake-up token for a waiter.
+// The list is trimmed to a single token and expires with the lease so idle locks leave no garbage.
+const RedisScript RELEASE_SCRIPT("lease_release",
+    "if redis.call('get', KEYS[1]) == ARGV[1] then "
+    "redis.call('del', KEYS[1]) "
+    "redis.call('rpush', KEYS[2], '1') "
+    "redis.call('ltrim', KEYS[2], 0, 0) "
+    "redis.call('pexpire', KEYS[2], ARGV[2]) "
+    "return 1 "
+    "else return 0 end");
+
+// KEYS: lock, fence. ARGV: token, ttl. Take the lease and draw the next fencing token in one
+// step, so no two holders ever share a token. Returns the token, or 0 when the lock is taken.
+const RedisScript ACQUIRE_SCRIPT("lease_acquire",
+    "if redis.call('set', KEYS[1], ARGV[1], 'NX', 'PX', ARGV[2]) then "
+    "return redis.call('incr', KEYS[2]) "
+    "else return 0 end");
+
+// Backoff between failed waits
+const std::chrono::milliseconds MIN_BACKOFF(1);
+const std::chrono::milliseconds MAX_BACKOFF(500);
+
+// Extend the lease only if it still carries our token
+const RedisScript RENEW_SCRIPT("lease_renew",
+    "if redis.call('get', KEYS[1]) == ARGV[1] then "
+    "return redis.call('pexpire', KEYS[1], ARGV[2]) "
+    "else return 0 end");
+
+} // namespace
+
+RedisLeaseLock::RedisLeaseLock(sw::redis::Redis& redis, const std::string& lockKey,
+                               std::chrono::milliseconds ttl, bool autoRenew, logging::ILogger* logger)
+    : redis_(redis), lockKey_(lockKey), wakeKey_(lockKey + ":wake"), fenceKey_(lockKey + ":fence"), ttl_(ttl),
+      autoRenew_(autoRenew), logger_(logger), fencingToken_(0), held_(false), instrumentation_(nullptr), renewalStop_(false) {
+}
+
+RedisLeaseLock::~RedisLeaseLock() {
+    if (this->held_) {
+        this->unlock();
+    }
+    this->stopRenewal();
+}
+
+bool RedisLeaseLock::tryLock() {
+    return this->tryLock(this->autoRenew_);
+}
+
+bool RedisLeaseLock::tryLock(bool autoRenew) {
+    if (this->held_) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Lease already held for lock: " + this->lockKey_);
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool acquired = this->acquire(autoRenew);
+    this->recordAcquire(acquired, start);
+    return acquired;
+}
+
+bool RedisLeaseLock::lock(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds backoff = MIN_BACKOFF;
+    if (this->held_) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Lease already held for lock: " + this->lockKey_);
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        if (this->acquire(this->autoRenew_)) {
+            this->recordAcquire(true, start);
+            return true;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            this->recordAcquire(false, start);
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Timed out waiting for lock: " + this->lockKey_);
+            return false;
+        }
+        // A release wakes us immediately; otherwise retry after a growing, jittered wait
+        if (this->waitForRelease(std::min(remaining, jitter(backoff)))) {
+            backoff = MIN_BACKOFF;
+        } else {
+            backoff = std::min(backoff * 2, MAX_BACKOFF);
+        }
+    }
+}
+
+bool RedisLeaseLock::unlock() {
+    this->stopRenewal();
+    bool wasHeld = this->held_.exchange(false);
+    if (!wasHeld) {
+        return false;
+    }
+    if (this->instrumentation_) {
+        this->instrumentation_->record(Instrumentation::Metric::LOCK_HOLD, std::chrono::steady_clock::now() - this->acquiredAt_);
+    }
+    try {
+        long long released = RELEASE_SCRIPT.call<long long>(this->redis_, {this->lockKey_, this->wakeKey_},
+                                                          {this->token_, std::to_string(this->ttl_.count())});
+        if (released == 1) {
+            return true;
+        }
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Lease for lock " + this->lockKey_ + " expired before release");
+        return false;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error releasing lease for lock " + this->lockKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisLeaseLock::renew() {
+    if (!this->held_) {
+        return false;
+    }
+    try {
+        long long renewed = RENEW_SCRIPT.call<long long>(this->redis_, {this->lockKey_},
+                                                         {this->token_, std::to_string(this->ttl_.count())});
+        if (renewed != 1) {
+            this->held_ = false;
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Lease lost for lock: " + this->lockKey_);
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error renewing lease for lock " + this->lockKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisLeaseLock::isHeld() const {
+    return this->held_;
+}
+
+bool RedisLeaseLock::isLocked() {
+    try {
+        return this->redis_.exists(this->lockKey_);
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error checking lease for lock " + this->lockKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+std::string RedisLeaseLock::token() const {
+    return this->token_;
+}
+
+long long RedisLeaseLock::fencingToken() const {
+    return this->fencingToken_;
+}
+
+const std::string& RedisLeaseLock::fenceKey() const {
+    return this->fenceKey_;
+}
+
+std::chrono::milliseconds RedisLeaseLock::ttl() const {
+    return this->ttl_;
+}
+
+void RedisLeaseLock::setInstrumentation(Instrumentation* instrumentation) {
+    this->instrumentation_ = instrumentation;
+}
+
+const RedisScript& RedisLeaseLock::acquireScript() {
+    return ACQUIRE_SCRIPT;
+}
+
+const RedisScript& RedisLeaseLock::releaseScript() {
+    return RELEASE_SCRIPT;
+}
+
+void RedisLeaseLock::registerScripts(RedisScriptRegistry& registry) {
+    for (const RedisScript* script : {&ACQUIRE_SCRIPT, &RELEASE_SCRIPT, &RENEW_SCRIPT}) {
+        registry.add(script->name(), script->body());
+    }
+}
+
+std::string RedisLeaseLock::generateToken() {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    static const char* const digits = "0123456789abcdef";
+    std::string token(32, '0');
+    for (int half = 0; half < 2; ++half) {
+        uint64_t bits = generator();
+        for (int i = 0; i < 16; ++i) {
+            token[half * 16 + i] = digits[(bits >> (i * 4)) & 0xF];
+        }
+    }
+    return token;
+}
+
+std::chrono::milliseconds RedisLeaseLock::jitter(std::chrono::milliseconds bound) {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    long long upper = std::max<long long>(bound.count(), 1);
+    std::uniform_int_distribution<long long> distribution((upper + 1) / 2, upper);
+    return std::chrono::milliseconds(distribution(generator));
+}
+
+bool RedisLeaseLock::acquire(bool autoRenew) {
+    try {
+        std::string token = generateToken();
+        long long fencingToken = ACQUIRE_SCRIPT.call<long long>(this->redis_, {this->lockKey_, this->fenceKey_},
+                                                                {token, std::to_string(this->ttl_.count())});
+        bool acquired = fencingToken > 0;
+        if (acquired) {
+            this->token_ = token;
+            this->fencingToken_ = fencingToken;
+            this->acquiredAt_ = std::chrono::steady_clock::now();
+            this->held_ = true;
+            if (autoRenew) {
+                this->startRenewal();
+            }
+        }
+        return acquired;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error acquiring lease for lock " + this->lockKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+void RedisLeaseLock::recordAcquire(bool acquired, std::chrono::steady_clock::time_point start) {
+    if (this->instrumentation_) {
+        this->instrumentation_->record(acquired ? Instrumentation::Metric::LOCK_ACQUIRED : Instrumentation::Metric::LOCK_FAILED,
+                                       std::chrono::steady_clock::now() - start);
+    }
+}
+
+bool RedisLeaseLock::waitForRelease(std::chrono::milliseconds timeout) {
+    try {
+        // BLPOP takes fractional seconds; zero would block forever
+        std::string seconds = std::to_string(std::max<long long>(timeout.count(), 1) / 1000.0);
+        auto token = this->redis_.command<sw::redis::OptionalStringPair>("BLPOP", this->wakeKey_, seconds);
+        return static_cast<bool>(token);
+    } catch (const sw::redis::TimeoutError&) {
+        return false; // Socket timeout shorter than the wait
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error waiting for release of lock " + this->lockKey_ + ": " + e.what());
+        std::this_thread::sleep_for(timeout);
+        return false;
+    }
+}
+
+void RedisLeaseLock::startRenewal() {
+    this->stopRenewal();
+    this->renewalStop_ = false;
+    // Renew at a third of the TTL so one failed attempt still leaves time for another
+    auto interval = this->ttl_ / 3;
+    this->renewalThread_ = std::make_unique<std::thread>([this, interval]() {
+        std::unique_lock<std::mutex> lock(this->renewalMutex_);
+        while (!this->renewalCv_.wait_for(lock, interval, [this]() { return this->renewalStop_; })) {
+            lock.unlock();
+            bool renewed = this->renew();
+            lock.lock();
+            if (!renewed && !this->held_) {
+                break;
+            }
+        }
+    });
+}
+
+void RedisLeaseLock::stopRenewal() {
+    if (!this->renewalThread_) {
+        return; // Lease taken without renewal
+    }
+    {
+        std::lock_guard<std::mutex> guard(this->renewalMutex_);
+        this->renewalStop_ = true;
+    }
+    this->renewalCv_.notify_all();
+    if (this->renewalThread_ && this->renewalThread_->joinable()) {
+        this->renewalThread_->join();
+    }
+    this->renewalThread_.reset();
+}
+
+
+} // namespace redis_extended
@@ -0,0 +1,135 @@
+#ifndef REDIS_EXTENDED_LEASE_LOCK_H
+#define REDIS_EXTENDED_LEASE_LOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace redis_extended {
+
+class Instrumentation;
+class RedisScript;
+class RedisScriptRegistry;
+
+// Distributed lock backed by a lease: SET key token NX PX ttl. Only the holder of the random
+// owner token can release or renew the lease, and a crashed holder blocks others for at most
+// one TTL. Long critical sections can keep the lease alive with automatic background renewal.
+// Blocking waiters sleep in BLPOP on <lockKey>:wake, which every release pushes a single token
+// to, so one waiter wakes per release instead of all of them polling the lock key. A waiter that
+// times out or loses the race retries with capped exponential backoff and jitter, which also
+// covers leases that expire without a release.
+//
+// Every acquisition also INCRs <lockKey>:fence in the same script and keeps the result as its
+// fencing token. The counter never expires and only grows, so a write made conditional on
+// the token still being the counter's value (see RedisKeyManager) is rejected server-side once
+// anyone else has acquired the lock, even if this holder has not yet noticed its lease is gone.
+class RedisLeaseLock {
+public:
+    // Constructor
+    RedisLeaseLock(sw::redis::Redis& redis, const std::string& lockKey,
+                   std::chrono::milliseconds ttl = std::chrono::seconds(30), bool autoRenew = true,
+                   logging::ILogger* logger = nullptr);
+
+    // Destructor; releases the lease if this instance still holds it
+    ~RedisLeaseLock();
+
+    RedisLeaseLock(const RedisLeaseLock&) = delete;
+    RedisLeaseLock& operator=(const RedisLeaseLock&) = delete;
+
+    // Try to acquire the lease once
+    bool tryLock();
+
+    // Try once, renewing in the background only if autoRenew. Short holds such as a single fenced
+    // write pass false so the acquisition does not start and join a renewal thread.
+    bool tryLock(bool autoRenew);
+
+    // Block until the lease is acquired or the timeout elapses. Each wait occupies a pooled
+    // connection in BLPOP, so the pool needs room for the waiting threads.
+    bool lock(std::chrono::milliseconds timeout);
+
+    // Release the lease if it is still owned by this instance; returns false if it was lost
+    bool unlock();
+
+    // Extend the lease by one TTL if it is still owned by this instance
+    bool renew();
+
+    // Whether this instance believes it holds the lease (cleared when a renewal finds it lost)
+    bool isHeld() const;
+
+    // Whether anyone currently holds the lease on the server
+    bool isLocked();
+
+    // Owner token of the current or last lease
+    std::string token() const;
+
+    // Fencing token of the current or last lease; 0 before the first acquisition
+    long long fencingToken() const;
+
+    // Counter the fencing tokens are drawn from
+    const std::string& fenceKey() const;
+
+    // Lease duration
+    std::chrono::milliseconds ttl() const;
+
+    // Record acquisition outcomes, wait and hold times (nullptr disables)
+    void setInstrumentation(Instrumentation* instrumentation);
+
+    // SET NX PX plus INCR of the fence; KEYS: lock, fence. ARGV: token, ttl. Returns the fencing
+    // token, or 0 when the lock is taken. Managers sharing the lock key acquire with it so the
+    // fence sees every holder.
+    static const RedisScript& acquireScript();
+
+    // Token-checked release that also signals one waiter; KEYS: lock, wake. ARGV: token, ttl.
+    // Shared by every manager that takes leases compatible with this lock.
+    static const RedisScript& releaseScript();
+
+    // Add the acquire, release and renew scripts to registry for preloading
+    static void registerScripts(RedisScriptRegistry& registry);
+
+    // Random 128-bit token rendered as hex
+    static std::string generateToken();
+
+    // Uniformly random duration in [bound / 2, bound], used to spread retries
+    static std::chrono::milliseconds jitter(std::chrono::milliseconds bound);
+
+private:
+    sw::redis::Redis& redis_;          // Reference to Redis connection
+    std::string lockKey_;              // Key holding the owner token
+    std::string wakeKey_;              // List receiving one token per release
+    std::string fenceKey_;             // Counter incremented by every acquisition
+    std::chrono::milliseconds ttl_;    // Lease duration
+    bool autoRenew_;                   // Renew in the background while held
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    std::string token_;                // Owner token of the current lease
+    long long fencingToken_;           // Fence counter value of the current lease
+    std::atomic<bool> held_;           // Local view of lease ownership
+    Instrumentation* instrumentation_; // Optional contention counters
+    std::chrono::steady_clock::time_point acquiredAt_; // Start of the current hold
+
+    std::unique_ptr<std::thread> renewalThread_; // Background lease renewal
+    std::mutex renewalMutex_;
+    std::condition_variable renewalCv_;
+    bool renewalStop_;
+
+    // Single SET NX PX + INCR attempt shared by tryLock() and lock()
+    bool acquire(bool autoRenew);
+
+    // Record an acquisition that started at `start`
+    void recordAcquire(bool acquired, std::chrono::steady_clock::time_point start);
+
+    // Wait up to timeout for a release signal; returns true if one was received
+    bool waitForRelease(std::chrono::milliseconds timeout);
+
+    void startRenewal();
+    void stopRenewal();
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_LEASE_LOCK_H
@@ -0,0 +1,327 @@
+#include "RedisNearCache.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <hiredis/hiredis.h>
+#include <poll.h>
+
+namespace redis_extended {
+
+namespace {
+
+const char* const INVALIDATE_CHANNEL = "__redis__:invalidate";
+
+// Fixed per-entry cost on top of key and value bytes: list node, hash node and string headers
+const size_t ENTRY_OVERHEAD = 128;
+
+struct ReplyHolder {
+    redisReply* reply;
+    explicit ReplyHolder(void* r) : reply(static_cast<redisReply*>(r)) {}
+    ~ReplyHolder() {
+        if (reply) freeReplyObject(reply);
+    }
+};
+
+// Connect and authenticate a raw hiredis connection; returns nullptr on failure
+redisContext* openConnection(const sw::redis::ConnectionOptions& options, std::string& error) {
+    struct timeval timeout;
+    std::chrono::milliseconds connectTimeout = options.connect_timeout.count() > 0
+        ? options.connect_timeout : std::chrono::milliseconds(1000);
+    timeout.tv_sec = static_cast<time_t>(connectTimeout.count() / 1000);
+    timeout.tv_usec = static_cast<suseconds_t>((connectTimeout.count() % 1000) * 1000);
+    redisContext* context = redisConnectWithTimeout(options.host.c_str(), options.port, timeout);
+    if (!context || context->err) {
+        error = context ? context->errstr : "cannot allocate context";
+        if (context) redisFree(context);
+        return nullptr;
+    }
+
+    if (!options.password.empty()) {
+        ReplyHolder auth(options.user.empty() || options.user == "default"
+            ? redisCommand(context, "AUTH %s", options.password.c_str())
+            : redisCommand(context, "AUTH %s %s", options.user.c_str(), options.password.c_str()));
+        if (!auth.reply || auth.reply->type == REDIS_REPLY_ERROR) {
+            error = auth.reply ? std::string(auth.reply->str, auth.reply->len) : context->errstr;
+            redisFree(context);
+            return nullptr;
+        }
+    }
+    if (options.db != 0) {
+        ReplyHolder select(redisCommand(context, "SELECT %d", options.db));
+        if (!select.reply || select.reply->type == REDIS_REPLY_ERROR) {
+            error = select.reply ? std::string(select.reply->str, select.reply->len) : context->errstr;
+            redisFree(context);
+            return nullptr;
+        }
+    }
+    return context;
+}
+
+} // namespace
+
+RedisNearCache::RedisNearCache(sw::redis::Redis& redis, const sw::redis::ConnectionOptions& options,
+                               size_t maxBytes, const std::vector<std::string>& prefixes,
+                               logging::ILogger* logger)
+    : redis_(redis), options_(options), maxBytes_(maxBytes), prefixes_(prefixes), logger_(logger),
+      bytes_(0), running_(false), active_(false), epoch_(0), hits_(0), misses_(0), invalidations_(0),
+      evictions_(0), listener_(nullptr), tracker_(nullptr) {
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Initialized RedisNearCache with a budget of " + std::to_string(this->maxBytes_) + " bytes");
+}
+
+RedisNearCache::~RedisNearCache() {
+    this->stop();
+}
+
+bool RedisNearCache::start() {
+    if (this->running_) {
+        return this->active_;
+    }
+    if (!this->connect()) {
+        return false;
+    }
+    this->active_ = true;
+    this->running_ = true;
+    this->listenerThread_ = std::thread([this]() { this->listen(); });
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Near cache tracking enabled");
+    return true;
+}
+
+void RedisNearCache::stop() {
+    this->running_ = false;
+    if (this->listenerThread_.joinable()) {
+        this->listenerThread_.join();
+    }
+    this->active_ = false;
+    this->disconnect();
+    this->clear();
+}
+
+sw::redis::OptionalString RedisNearCache::get(const std::string& key) {
+    if (this->active_) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        auto it = this->index_.find(key);
+        if (it != this->index_.end()) {
+            this->lru_.splice(this->lru_.begin(), this->lru_, it->second);
+            this->hits_++;
+            return sw::redis::OptionalString(it->second->value);
+        }
+    }
+    this->misses_++;
+
+    // Remember the epoch before the round trip: an invalidation racing with the GET must win
+    uint64_t epoch = this->epoch_.load();
+    auto value = this->redis_.get(key);
+    if (value && this->active_) {
+        this->insert(key, *value, epoch);
+    }
+    return value;
+}
+
+void RedisNearCache::invalidate(const std::string& key) {
+    this->epoch_++;
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->index_.find(key);
+    if (it != this->index_.end()) {
+        this->bytes_ -= entryBytes(it->second->key, it->second->value);
+        this->lru_.erase(it->second);
+        this->index_.erase(it);
+    }
+}
+
+void RedisNearCache::clear() {
+    this->epoch_++;
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->lru_.clear();
+    this->index_.clear();
+    this->bytes_ = 0;
+}
+
+bool RedisNearCache::isActive() const {
+    return this->active_;
+}
+
+RedisNearCache::Stats RedisNearCache::stats() const {
+    Stats stats;
+    stats.hits = this->hits_.load();
+    stats.misses = this->misses_.load();
+    stats.invalidations = this->invalidations_.load();
+    stats.evictions = this->evictions_.load();
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    stats.entries = this->index_.size();
+    stats.bytes = this->bytes_;
+    return stats;
+}
+
+bool RedisNearCache::connect() {
+    std::string error;
+    this->listener_ = openConnection(this->options_, error);
+    if (!this->listener_) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Near cache cannot connect invalidation listener: " + error);
+        return false;
+    }
+
+    ReplyHolder id(redisCommand(this->listener_, "CLIENT ID"));
+    ReplyHolder subscribed(redisCommand(this->listener_, "SUBSCRIBE %s", INVALIDATE_CHANNEL));
+    if (!id.reply || id.reply->type != REDIS_REPLY_INTEGER || !subscribed.reply
+        || subscribed.reply->type == REDIS_REPLY_ERROR) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Near cache cannot subscribe to " + std::string(INVALIDATE_CHANNEL));
+        this->disconnect();
+        return false;
+    }
+
+    this->tracker_ = openConnection(this->options_, error);
+    if (!this->tracker_) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Near cache cannot connect tracking client: " + error);
+        this->disconnect();
+        return false;
+    }
+    std::vector<std::string> args = {"CLIENT", "TRACKING", "on", "REDIRECT", std::to_string(id.reply->integer), "BCAST"};
+    for (const auto& prefix : this->prefixes_) {
+        args.push_back("PREFIX");
+        args.push_back(prefix);
+    }
+    std::vector<const char*> argv;
+    std::vector<size_t> argvlen;
+    for (const auto& arg : args) {
+        argv.push_back(arg.data());
+        argvlen.push_back(arg.size());
+    }
+    ReplyHolder tracking(redisCommandArgv(this->tracker_, static_cast<int>(argv.size()), argv.data(), argvlen.data()));
+    if (!tracking.reply || tracking.reply->type == REDIS_REPLY_ERROR) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Near cache cannot enable CLIENT TRACKING: "
+                  + (tracking.reply ? std::string(tracking.reply->str, tracking.reply->len) : std::string(this->tracker_->errstr)));
+        this->disconnect();
+        return false;
+    }
+    return true;
+}
+
+void RedisNearCache::disconnect() {
+    if (this->listener_) {
+        redisFree(this->listener_);
+        this->listener_ = nullptr;
+    }
+    if (this->tracker_) {
+        redisFree(this->tracker_);
+        this->tracker_ = nullptr;
+    }
+}
+
+void RedisNearCache::listen() {
+    auto lastCheck = std::chrono::steady_clock::now();
+    while (this->running_) {
+        if (!this->listener_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (std::chrono::steady_clock::now() - lastCheck >= std::chrono::seconds(1)) {
+                lastCheck = std::chrono::steady_clock::now();
+                if (this->connect()) {
+                    this->active_ = true;
+                    REDIS_EXTENDED_LOG(this->logger_, INFO, "Near cache tracking re-established");
+                }
+            }
+            continue;
+        }
+
+        bool healthy = true;
+        void* raw = nullptr;
+        if (redisGetReplyFromReader(this->listener_, &raw) != REDIS_OK) {
+            healthy = false;
+        } else if (raw) {
+            ReplyHolder message(raw);
+            this->handleInvalidation(message.reply);
+            continue;
+        } else {
+            struct pollfd pfd;
+            pfd.fd = this->listener_->fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int ready = poll(&pfd, 1, 100);
+            if (ready < 0 && errno != EINTR) {
+                healthy = false;
+            } else if (ready > 0 && redisBufferRead(this->listener_) != REDIS_OK) {
+                healthy = false;
+            }
+        }
+
+        // Tracking ends silently if the tracking connection dies, so probe it once per second
+        if (healthy && std::chrono::steady_clock::now() - lastCheck >= std::chrono::seconds(1)) {
+            lastCheck = std::chrono::steady_clock::now();
+            ReplyHolder pong(redisCommand(this->tracker_, "PING"));
+            healthy = pong.reply && pong.reply->type != REDIS_REPLY_ERROR;
+        }
+
+        if (!healthy) {
+            // Without invalidations nothing cached can be trusted
+            this->active_ = false;
+            this->clear();
+            this->disconnect();
+            lastCheck = std::chrono::steady_clock::now();
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Near cache lost its tracking connection; serving reads from Redis");
+        }
+    }
+}
+
+void RedisNearCache::handleInvalidation(redisReply* reply) {
+    // RESP2 pub/sub message: ["message", "__redis__:invalidate", [key, ...] or nil for a flush]
+    if ((reply->type != REDIS_REPLY_ARRAY && reply->type != REDIS_REPLY_PUSH) || reply->elements != 3) {
+        return;
+    }
+    const redisReply* kind = reply->element[0];
+    if (kind->type != REDIS_REPLY_STRING || std::string(kind->str, kind->len) != "message") {
+        return;
+    }
+    const redisReply* keys = reply->element[2];
+    if (keys->type == REDIS_REPLY_NIL) {
+        this->clear();
+        this->invalidations_++;
+        return;
+    }
+    if (keys->type != REDIS_REPLY_ARRAY) {
+        return;
+    }
+    for (size_t i = 0; i < keys->elements; ++i) {
+        const redisReply* key = keys->element[i];
+        if (key->type == REDIS_REPLY_STRING) {
+            this->invalidate(std::string(key->str, key->len));
+            this->invalidations_++;
+        }
+    }
+}
+
+void RedisNearCache::insert(const std::string& key, const std::string& value, uint64_t epoch) {
+    size_t bytes = entryBytes(key, value);
+    if (bytes > this->maxBytes_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (this->epoch_.load() != epoch) {
+        return; // Invalidated while the value was in flight
+    }
+    auto it = this->index_.find(key);
+    if (it != this->index_.end()) {
+        this->bytes_ -= entryBytes(it->second->key, it->second->value);
+        this->lru_.erase(it->second);
+        this->index_.erase(it);
+    }
+    this->lru_.push_front(Entry{key, value});
+    this->index_[key] = this->lru_.begin();
+    this->bytes_ += bytes;
+    this->evictLocked();
+}
+
+void RedisNearCache::evictLocked() {
+    while (this->bytes_ > this->maxBytes_ && !this->lru_.empty()) {
+        const Entry& victim = this->lru_.back();
+        this->bytes_ -= entryBytes(victim.key, victim.value);
+        this->index_.erase(victim.key);
+        this->lru_.pop_back();
+        this->evictions_++;
+    }
+}
+
+size_t RedisNearCache::entryBytes(const std::string& key, const std::string& value) {
+    return key.size() + value.size() + ENTRY_OVERHEAD;
+}
+
+
+} // namespace redis_extended
@@ -0,0 +1,113 @@
+#ifndef REDIS_EXTENDED_NEAR_CACHE_H
+#define REDIS_EXTENDED_NEAR_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+struct redisContext;
+struct redisReply;
+
+namespace redis_extended {
+
+// Process-local read cache kept coherent by Redis client-side caching. A dedicated connection
+// subscribes to __redis__:invalidate and a second one enables
+//   CLIENT TRACKING on REDIRECT <listener id> BCAST [PREFIX p ...]
+// so the server pushes every modification of a tracked key (by any client) to the listener,
+// which drops the entry. Broadcasting mode is used because reads go through the redis++
+// connection pool, whose connections cannot each be put in default tracking mode. Entries are
+// evicted in LRU order once their bytes exceed the budget. While the listener is disconnected
+// the cache is emptied and every read goes to Redis.
+class RedisNearCache {
+public:
+    // Cache counters
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0; // Keys dropped on server notification (flushes count once)
+        uint64_t evictions = 0;     // Keys dropped to stay within the memory budget
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    // Constructor; options must point at the same server as redis. Empty prefixes track all keys.
+    RedisNearCache(sw::redis::Redis& redis, const sw::redis::ConnectionOptions& options,
+                   size_t maxBytes = 64 * 1024 * 1024, const std::vector<std::string>& prefixes = {},
+                   logging::ILogger* logger = nullptr);
+
+    // Destructor; stops the invalidation listener
+    ~RedisNearCache();
+
+    RedisNearCache(const RedisNearCache&) = delete;
+    RedisNearCache& operator=(const RedisNearCache&) = delete;
+
+    // Connect the listener and enable tracking; returns false if tracking could not be enabled
+    bool start();
+
+    // Stop the listener and drop every entry
+    void stop();
+
+    // Cached GET: served locally on a hit, fetched from Redis and cached on a miss
+    sw::redis::OptionalString get(const std::string& key);
+
+    // Drop one entry (e.g. after a local write) or all of them
+    void invalidate(const std::string& key);
+    void clear();
+
+    // True while invalidations are being received and the cache is serving reads
+    bool isActive() const;
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string value;
+    };
+
+    sw::redis::Redis& redis_;                 // Connection pool used for cache misses
+    sw::redis::ConnectionOptions options_;    // Endpoint for the listener and tracking connections
+    size_t maxBytes_;                         // Memory budget for keys and values
+    std::vector<std::string> prefixes_;       // BCAST prefixes; empty tracks every key
+    logging::ILogger* logger_;                // Logger instance for tracking operations
+
+    mutable std::mutex mutex_;                // Guards lru_, index_ and bytes_
+    std::list<Entry> lru_;                    // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t bytes_;
+
+    std::atomic<bool> running_;               // Listener thread keeps going while set
+    std::atomic<bool> active_;                // Tracking established; cache may serve reads
+    std::atomic<uint64_t> epoch_;             // Bumped on every invalidation, guards miss fills
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> invalidations_;
+    std::atomic<uint64_t> evictions_;
+    redisContext* listener_;                  // Subscribed to __redis__:invalidate
+    redisContext* tracker_;                   // Owns the CLIENT TRACKING registration
+    std::thread listenerThread_;
+
+    // Open both connections and register tracking; closes them again on failure
+    bool connect();
+    void disconnect();
+
+    // Receive invalidation messages until stopped, reconnecting after connection loss
+    void listen();
+    void handleInvalidation(redisReply* reply);
+
+    // Insert a value fetched at the given epoch unless an invalidation happened meanwhile
+    void insert(const std::string& key, const std::string& value, uint64_t epoch);
+    void evictLocked();
+    static size_t entryBytes(const std::string& key, const std::string& value);
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_NEAR_CACHE_H
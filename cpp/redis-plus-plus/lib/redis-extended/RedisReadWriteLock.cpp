@@ -0,0 +1,236 @@
+#include "RedisReadWriteLock.h"
+#include "RedisScriptRegistry.h"
+#include "RedisLeaseLock.h"
+#include <algorithm>
+#include <thread>
+
+namespace redis_extended {
+
+namespace {
+
+// Milliseconds of server time, shared by every script
+#define RWLOCK_NOW \
+    "local t = redis.call('time') " \
+    "local now = tonumber(t[1]) * 1000 + math.floor(tonumber(t[2]) / 1000) "
+
+// KEYS: writer, readers, intent. ARGV: token, ttl.
+const RedisScript ACQUIRE_SHARED_SCRIPT("acquire_shared",
+    "if redis.call('exists', KEYS[1]) == 1 or redis.call('exists', KEYS[3]) == 1 then return 0 end "
+    RWLOCK_NOW
+    "redis.call('zremrangebyscore', KEYS[2], '-inf', now) "
+    "redis.call('zadd', KEYS[2], now + tonumber(ARGV[2]), ARGV[1]) "
+    "if redis.call('pttl', KEYS[2]) < tonumber(ARGV[2]) then redis.call('pexpire', KEYS[2], ARGV[2]) end "
+    "return 1");
+
+// KEYS: readers, wake. ARGV: token, ttl. The last reader out signals one waiting writer.
+const RedisScript RELEASE_SHARED_SCRIPT("release_shared",
+    "if redis.call('zrem', KEYS[1], ARGV[1]) == 0 then return 0 end "
+    RWLOCK_NOW
+    "redis.call('zremrangebyscore', KEYS[1], '-inf', now) "
+    "if redis.call('zcard', KEYS[1]) == 0 then "
+    "redis.call('rpush', KEYS[2], '1') "
+    "redis.call('ltrim', KEYS[2], 0, 0) "
+    "redis.call('pexpire', KEYS[2], ARGV[2]) "
+    "end "
+    "return 1");
+
+// KEYS: writer, readers, intent. ARGV: token, ttl, register intent (0/1), intent ttl.
+// Only the writer owning the intent (or any writer when there is none) may take the lock.
+const RedisScript ACQUIRE_EXCLUSIVE_SCRIPT("acquire_exclusive",
+    RWLOCK_NOW
+    "redis.call('zremrangebyscore', KEYS[2], '-inf', now) "
+    "local intent = redis.call('get', KEYS[3]) "
+    "local mine = (intent == false or intent == ARGV[1]) "
+    "if mine and redis.call('exists', KEYS[1]) == 0 and redis.call('zcard', KEYS[2]) == 0 then "
+    "redis.call('set', KEYS[1], ARGV[1], 'PX', ARGV[2]) "
+    "if intent == ARGV[1] then redis.call('del', KEYS[3]) end "
+    "return 1 "
+    "end "
+    "if ARGV[3] == '1' and mine then redis.call('set', KEYS[3], ARGV[1], 'PX', ARGV[4]) end "
+    "return 0");
+
+// KEYS: writer, wake. ARGV: token, ttl.
+const RedisScript RELEASE_EXCLUSIVE_SCRIPT("release_exclusive",
+    "if redis.call('get', KEYS[1]) ~= ARGV[1] then return 0 end "
+    "redis.call('del', KEYS[1]) "
+    "redis.call('rpush', KEYS[2], '1') "
+    "redis.call('ltrim', KEYS[2], 0, 0) "
+    "redis.call('pexpire', KEYS[2], ARGV[2]) "
+    "return 1");
+
+// KEYS: intent. ARGV: token. Withdraw a writer intent after giving up.
+const RedisScript WITHDRAW_INTENT_SCRIPT("withdraw_intent",
+    "if redis.call('get', KEYS[1]) == ARGV[1] then return redis.call('del', KEYS[1]) end "
+    "return 0");
+
+#undef RWLOCK_NOW
+
+// A waiting writer refreshes its intent on every attempt; an abandoned intent blocks readers
+// for at most this long
+const std::chrono::milliseconds INTENT_TTL(2000);
+
+// Backoff between failed attempts
+const std::chrono::milliseconds MIN_BACKOFF(1);
+const std::chrono::milliseconds MAX_READER_BACKOFF(100);
+const std::chrono::milliseconds MAX_WRITER_BACKOFF(500);
+
+} // namespace
+
+RedisReadWriteLock::RedisReadWriteLock(sw::redis::Redis& redis, const std::string& name,
+                                       std::chrono::milliseconds ttl, logging::ILogger* logger)
+    : redis_(redis), writerKey_("rwlock:{" + name + "}:writer"), readersKey_("rwlock:{" + name + "}:readers"),
+      intentKey_("rwlock:{" + name + "}:intent"), wakeKey_("rwlock:{" + name + "}:wake"), ttl_(ttl),
+      logger_(logger), token_(RedisLeaseLock::generateToken()), shared_(false), exclusive_(false) {
+}
+
+RedisReadWriteLock::~RedisReadWriteLock() {
+    if (this->exclusive_) {
+        this->unlock();
+    }
+    if (this->shared_) {
+        this->unlockShared();
+    }
+}
+
+bool RedisReadWriteLock::tryLockShared() {
+    if (this->shared_ || this->exclusive_) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Read-write lock already held: " + this->writerKey_);
+        return false;
+    }
+    try {
+        long long acquired = ACQUIRE_SHARED_SCRIPT.call<long long>(this->redis_, {this->writerKey_, this->readersKey_, this->intentKey_},
+            {this->token_, std::to_string(this->ttl_.count())});
+        this->shared_ = acquired == 1;
+        return this->shared_;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error acquiring shared lock " + this->readersKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisReadWriteLock::lockShared(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds backoff = MIN_BACKOFF;
+    while (!this->tryLockShared()) {
+        if (this->shared_ || this->exclusive_) {
+            return false;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Timed out waiting for shared lock: " + this->readersKey_);
+            return false;
+        }
+        // Wake-up tokens are reserved for writers; readers poll with a short capped backoff
+        std::this_thread::sleep_for(std::min(remaining, RedisLeaseLock::jitter(backoff)));
+        backoff = std::min(backoff * 2, MAX_READER_BACKOFF);
+    }
+    return true;
+}
+
+bool RedisReadWriteLock::unlockShared() {
+    if (!this->shared_) {
+        return false;
+    }
+    this->shared_ = false;
+    try {
+        long long released = RELEASE_SHARED_SCRIPT.call<long long>(this->redis_, {this->readersKey_, this->wakeKey_}, {this->token_, std::to_string(this->ttl_.count())});
+        if (released != 1) {
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Shared lease expired before release: " + this->readersKey_);
+        }
+        return released == 1;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error releasing shared lock " + this->readersKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisReadWriteLock::tryLock() {
+    if (this->shared_ || this->exclusive_) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Read-write lock already held: " + this->writerKey_);
+        return false;
+    }
+    return this->acquireExclusive(false);
+}
+
+bool RedisReadWriteLock::lock(std::chrono::milliseconds timeout) {
+    if (this->shared_ || this->exclusive_) {
+        REDIS_EXTENDED_LOG(this->logger_, WARNING, "Read-write lock already held: " + this->writerKey_);
+        return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds backoff = MIN_BACKOFF;
+    while (!this->acquireExclusive(true)) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            try {
+                WITHDRAW_INTENT_SCRIPT.call<long long>(this->redis_, {this->intentKey_}, {this->token_});
+            } catch (const std::exception& e) {
+                REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error withdrawing writer intent " + this->intentKey_ + ": " + e.what());
+            }
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Timed out waiting for exclusive lock: " + this->writerKey_);
+            return false;
+        }
+        // Sleep until the lock becomes free, bounded so the intent is refreshed before it expires
+        std::chrono::milliseconds wait = std::min(remaining, RedisLeaseLock::jitter(backoff));
+        try {
+            std::string seconds = std::to_string(std::max<long long>(wait.count(), 1) / 1000.0);
+            auto token = this->redis_.command<sw::redis::OptionalStringPair>("BLPOP", this->wakeKey_, seconds);
+            backoff = token ? MIN_BACKOFF : std::min(backoff * 2, MAX_WRITER_BACKOFF);
+        } catch (const sw::redis::TimeoutError&) {
+            backoff = std::min(backoff * 2, MAX_WRITER_BACKOFF);
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error waiting for exclusive lock " + this->writerKey_ + ": " + e.what());
+            std::this_thread::sleep_for(wait);
+            backoff = std::min(backoff * 2, MAX_WRITER_BACKOFF);
+        }
+    }
+    return true;
+}
+
+bool RedisReadWriteLock::unlock() {
+    if (!this->exclusive_) {
+        return false;
+    }
+    this->exclusive_ = false;
+    try {
+        long long released = RELEASE_EXCLUSIVE_SCRIPT.call<long long>(this->redis_, {this->writerKey_, this->wakeKey_}, {this->token_, std::to_string(this->ttl_.count())});
+        if (released != 1) {
+            REDIS_EXTENDED_LOG(this->logger_, WARNING, "Exclusive lease expired before release: " + this->writerKey_);
+        }
+        return released == 1;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error releasing exclusive lock " + this->writerKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+bool RedisReadWriteLock::holdsShared() const {
+    return this->shared_;
+}
+
+bool RedisReadWriteLock::holdsExclusive() const {
+    return this->exclusive_;
+}
+
+void RedisReadWriteLock::registerScripts(RedisScriptRegistry& registry) {
+    for (const RedisScript* script : {&ACQUIRE_SHARED_SCRIPT, &RELEASE_SHARED_SCRIPT, &ACQUIRE_EXCLUSIVE_SCRIPT,
+                                      &RELEASE_EXCLUSIVE_SCRIPT, &WITHDRAW_INTENT_SCRIPT}) {
+        registry.add(script->name(), script->body());
+    }
+}
+
+bool RedisReadWriteLock::acquireExclusive(bool registerIntent) {
+    try {
+        long long acquired = ACQUIRE_EXCLUSIVE_SCRIPT.call<long long>(this->redis_, {this->writerKey_, this->readersKey_, this->intentKey_},
+            {this->token_, std::to_string(this->ttl_.count()), registerIntent ? "1" : "0",
+             std::to_string(INTENT_TTL.count())});
+        this->exclusive_ = acquired == 1;
+        return this->exclusive_;
+    } catch (const std::exception& e) {
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error acquiring exclusive lock " + this->writerKey_ + ": " + e.what());
+        return false;
+    }
+}
+
+
+} // namespace redis_extended
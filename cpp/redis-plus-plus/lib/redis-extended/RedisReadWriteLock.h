@@ -0,0 +1,71 @@
+#ifndef REDIS_EXTENDED_READ_WRITE_LOCK_H
+#define REDIS_EXTENDED_READ_WRITE_LOCK_H
+
+#include <chrono>
+#include <string>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace redis_extended {
+
+class RedisScriptRegistry;
+
+// Distributed shared/exclusive lock. All state lives under one hash tag so every script touches
+// a single slot:
+//   rwlock:{name}:writer   owner token of the exclusive holder (PX ttl)
+//   rwlock:{name}:readers  sorted set of shared holders scored by lease expiry (server time)
+//   rwlock:{name}:intent   token of the first writer waiting in lock() (PX ttl)
+//   rwlock:{name}:wake     one token per transition to free, popped by waiting writers
+// Readers are admitted only while there is neither a writer nor a writer intent, which gives
+// waiting writers preference and keeps a steady stream of readers from starving them. Expired
+// shared holders are pruned on every acquisition. Leases are not renewed, so ttl must cover the
+// longest critical section.
+class RedisReadWriteLock {
+public:
+    // Constructor
+    RedisReadWriteLock(sw::redis::Redis& redis, const std::string& name,
+                       std::chrono::milliseconds ttl = std::chrono::seconds(30),
+                       logging::ILogger* logger = nullptr);
+
+    // Destructor; releases whichever side this instance holds
+    ~RedisReadWriteLock();
+
+    RedisReadWriteLock(const RedisReadWriteLock&) = delete;
+    RedisReadWriteLock& operator=(const RedisReadWriteLock&) = delete;
+
+    // Shared side: any number of holders, excluded by a writer or a waiting writer
+    bool tryLockShared();
+    bool lockShared(std::chrono::milliseconds timeout);
+    bool unlockShared();
+
+    // Exclusive side: a single holder, excluded by any reader or writer
+    bool tryLock();
+    bool lock(std::chrono::milliseconds timeout);
+    bool unlock();
+
+    // Local view of what this instance holds
+    bool holdsShared() const;
+    bool holdsExclusive() const;
+
+    // Add the shared and exclusive lease scripts to registry for preloading
+    static void registerScripts(RedisScriptRegistry& registry);
+
+private:
+    sw::redis::Redis& redis_;          // Reference to Redis connection
+    std::string writerKey_;            // Exclusive owner token
+    std::string readersKey_;           // Shared owners scored by expiry
+    std::string intentKey_;            // Waiting writer announcing itself to readers
+    std::string wakeKey_;              // Release signal for waiting writers
+    std::chrono::milliseconds ttl_;    // Lease duration for both sides
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    std::string token_;                // Owner token of this instance
+    bool shared_;                      // Holds the shared side
+    bool exclusive_;                   // Holds the exclusive side
+
+    // One exclusive attempt; registerIntent makes readers stand back while we wait
+    bool acquireExclusive(bool registerIntent);
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_READ_WRITE_LOCK_H
@@ -0,0 +1,173 @@
+#include "RedisScriptRegistry.h"
+#include <cstdint>
+#include <cstring>
+
+namespace redis_extended {
+
+namespace {
+
+uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// Process one 64-byte block (FIPS 180-4, section 6.1.2)
+void sha1Block(uint32_t state[5], const unsigned char* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) | (static_cast<uint32_t>(block[i * 4 + 1]) << 16)
+             | (static_cast<uint32_t>(block[i * 4 + 2]) << 8) | static_cast<uint32_t>(block[i * 4 + 3]);
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+} // namespace
+
+RedisScript::RedisScript(const std::string& name, const std::string& body)
+    : name_(name), body_(body), sha_(sha1Hex(body)), fallbacks_(0) {
+}
+
+const std::string& RedisScript::name() const {
+    return this->name_;
+}
+
+const std::string& RedisScript::body() const {
+    return this->body_;
+}
+
+const std::string& RedisScript::sha() const {
+    return this->sha_;
+}
+
+bool RedisScript::load(sw::redis::Redis& redis) const {
+    return redis.script_load(this->body_) == this->sha_;
+}
+
+uint64_t RedisScript::fallbacks() const {
+    return this->fallbacks_.load(std::memory_order_relaxed);
+}
+
+bool RedisScript::isNoScript(const sw::redis::ReplyError& error) {
+    return std::strncmp(error.what(), "NOSCRIPT", 8) == 0;
+}
+
+std::string RedisScript::sha1Hex(const std::string& data) {
+    uint32_t state[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    size_t length = data.size();
+    size_t offset = 0;
+    for (; offset + 64 <= length; offset += 64) {
+        sha1Block(state, bytes + offset);
+    }
+
+    // Padding: 0x80, zeros, then the message length in bits as a 64-bit big-endian integer
+    unsigned char tail[128] = {0};
+    size_t remaining = length - offset;
+    std::memcpy(tail, bytes + offset, remaining);
+    tail[remaining] = 0x80;
+    size_t tailLength = remaining + 1 + 8 <= 64 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(length) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tailLength - 1 - i] = static_cast<unsigned char>(bits >> (i * 8));
+    }
+    for (size_t block = 0; block < tailLength; block += 64) {
+        sha1Block(state, tail + block);
+    }
+
+    static const char* const digits = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(40);
+    for (uint32_t word : state) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            hex.push_back(digits[(word >> shift) & 0xF]);
+        }
+    }
+    return hex;
+}
+
+RedisScriptRegistry::RedisScriptRegistry(logging::ILogger* logger) : logger_(logger) {
+}
+
+RedisScriptRegistry::~RedisScriptRegistry() {
+}
+
+const RedisScript& RedisScriptRegistry::add(const std::string& name, const std::string& body) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->scripts_.find(name);
+    if (it != this->scripts_.end()) {
+        if (it->second->body() != body) {
+            throw std::invalid_argument("Script " + name + " is already registered with a different body");
+        }
+        return *it->second;
+    }
+    auto script = std::make_unique<RedisScript>(name, body);
+    const RedisScript& result = *script;
+    this->scripts_.emplace(name, std::move(script));
+    REDIS_EXTENDED_LOG(this->logger_, DEBUG, "Registered script " + name + " (" + result.sha() + ")");
+    return result;
+}
+
+const RedisScript* RedisScriptRegistry::find(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    auto it = this->scripts_.find(name);
+    return it != this->scripts_.end() ? it->second.get() : nullptr;
+}
+
+size_t RedisScriptRegistry::preload(sw::redis::Redis& redis) const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    size_t loaded = 0;
+    for (const auto& entry : this->scripts_) {
+        try {
+            if (entry.second->load(redis)) {
+                ++loaded;
+            } else {
+                REDIS_EXTENDED_LOG(this->logger_, WARNING, "Server SHA of script " + entry.first + " differs from " + entry.second->sha());
+            }
+        } catch (const std::exception& e) {
+            REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error loading script " + entry.first + ": " + e.what());
+        }
+    }
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Preloaded " + std::to_string(loaded) + " of " + std::to_string(this->scripts_.size()) + " scripts");
+    return loaded;
+}
+
+std::vector<std::string> RedisScriptRegistry::names() const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    std::vector<std::string> result;
+    result.reserve(this->scripts_.size());
+    for (const auto& entry : this->scripts_) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+} // namespace redis_extended
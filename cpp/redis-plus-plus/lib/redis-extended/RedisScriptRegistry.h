@@ -0,0 +1,125 @@
+#ifndef REDIS_EXTENDED_SCRIPT_REGISTRY_H
+#define REDIS_EXTENDED_SCRIPT_REGISTRY_H
+
+#include <atomic>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace redis_extended {
+
+// Lua script invoked by SHA. The SHA1 is computed locally when the script is constructed, so a
+// call is a single EVALSHA carrying only keys and arguments. A server that does not know the
+// script (first use, restart, failover to a replica, SCRIPT FLUSH) answers NOSCRIPT; the call is
+// then repeated once as EVAL, which also caches the script on that server, so later calls are
+// EVALSHA again. This works the same for sw::redis::Redis and sw::redis::RedisCluster, where
+// each shard learns the script on its first NOSCRIPT.
+class RedisScript {
+public:
+    // Constructor
+    RedisScript(const std::string& name, const std::string& body);
+
+    RedisScript(const RedisScript&) = delete;
+    RedisScript& operator=(const RedisScript&) = delete;
+
+    const std::string& name() const;
+    const std::string& body() const;
+    const std::string& sha() const;
+
+    // Run the script and convert the reply to Result; redis++ errors other than NOSCRIPT propagate
+    template <typename Result, typename Client>
+    Result call(Client& client, std::initializer_list<sw::redis::StringView> keys,
+                std::initializer_list<sw::redis::StringView> args) const;
+
+    // SCRIPT LOAD on the server behind redis; false if the server's SHA differs from sha()
+    bool load(sw::redis::Redis& redis) const;
+
+    // Number of calls that fell back to EVAL
+    uint64_t fallbacks() const;
+
+    // Whether a reply error is the server's NOSCRIPT answer
+    static bool isNoScript(const sw::redis::ReplyError& error);
+
+    // Lowercase hex SHA1 of data, the digest Redis uses to identify scripts
+    static std::string sha1Hex(const std::string& data);
+
+private:
+    std::string name_;                       // Label used in logs and by the registry
+    std::string body_;                       // Lua source
+    std::string sha_;                        // SHA1 of body_
+    mutable std::atomic<uint64_t> fallbacks_; // NOSCRIPT answers seen
+};
+
+// Named RedisScript set shared by the managers of an application. Scripts can be preloaded with
+// SCRIPT LOAD at startup so the first calls do not pay the EVAL fallback. The library's own
+// scripts are added with the registerScripts() of the modules in use (RedisKeyManager,
+// RedisLeaseLock, RedisReadWriteLock, RedisClusterKeyManager); the managers keep calling their
+// own RedisScript objects, which share the SHA and so hit the preloaded copy.
+class RedisScriptRegistry {
+public:
+    // Constructor
+    explicit RedisScriptRegistry(logging::ILogger* logger = nullptr);
+
+    // Destructor
+    ~RedisScriptRegistry();
+
+    RedisScriptRegistry(const RedisScriptRegistry&) = delete;
+    RedisScriptRegistry& operator=(const RedisScriptRegistry&) = delete;
+
+    // Register a script; re-adding a name returns the existing script if the body is unchanged
+    // and throws std::invalid_argument otherwise
+    const RedisScript& add(const std::string& name, const std::string& body);
+
+    // Registered script, or nullptr
+    const RedisScript* find(const std::string& name) const;
+
+    // Run a registered script; throws std::invalid_argument for an unknown name
+    template <typename Result, typename Client>
+    Result call(Client& client, const std::string& name, std::initializer_list<sw::redis::StringView> keys,
+                std::initializer_list<sw::redis::StringView> args) const;
+
+    // SCRIPT LOAD every registered script; returns how many were loaded
+    size_t preload(sw::redis::Redis& redis) const;
+
+    // Names of the registered scripts
+    std::vector<std::string> names() const;
+
+private:
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    mutable std::mutex mutex_;         // Guards scripts_
+    std::map<std::string, std::unique_ptr<RedisScript>> scripts_; // Stable addresses for add()
+};
+
+template <typename Result, typename Client>
+Result RedisScript::call(Client& client, std::initializer_list<sw::redis::StringView> keys,
+                         std::initializer_list<sw::redis::StringView> args) const {
+    try {
+        return client.template evalsha<Result>(this->sha_, keys, args);
+    } catch (const sw::redis::ReplyError& e) {
+        if (!isNoScript(e)) {
+            throw;
+        }
+    }
+    this->fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return client.template eval<Result>(this->body_, keys, args);
+}
+
+template <typename Result, typename Client>
+Result RedisScriptRegistry::call(Client& client, const std::string& name, std::initializer_list<sw::redis::StringView> keys,
+                                 std::initializer_list<sw::redis::StringView> args) const {
+    const RedisScript* script = this->find(name);
+    if (!script) {
+        throw std::invalid_argument("Unknown script: " + name);
+    }
+    return script->call<Result>(client, keys, args);
+}
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_SCRIPT_REGISTRY_H
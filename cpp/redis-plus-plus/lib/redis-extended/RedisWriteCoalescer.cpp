@@ -0,0 +1,170 @@
+#include "RedisWriteCoalescer.h"
+#include "TraceRecorder.h"
+#include <Trace.h>
+#include <algorithm>
+#include <utility>
+
+namespace redis_extended {
+
+RedisWriteCoalescer::RedisWriteCoalescer(sw::redis::Redis& redis, std::chrono::milliseconds window,
+                                         size_t batchSize, uint8_t threadId, logging::ILogger* logger)
+    : redis_(redis), window_(std::max(window, std::chrono::milliseconds(1))), batchSize_(batchSize > 0 ? batchSize : 1), threadId_(threadId),
+      logger_(logger), tracer_(nullptr), replicas_(0), replicaTimeout_(0), running_(true), writes_(0),
+      coalesced_(0), flushedKeys_(0), batches_(0), failures_(0) {
+    this->flusher_ = std::thread([this]() { this->run(); });
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Initialized RedisWriteCoalescer with a " + std::to_string(this->window_.count())
+        + "ms window for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+}
+
+RedisWriteCoalescer::~RedisWriteCoalescer() {
+    {
+        std::lock_guard<std::mutex> lock(this->pendingMutex_);
+        this->running_ = false;
+    }
+    this->wakeCv_.notify_all();
+    if (this->flusher_.joinable()) {
+        this->flusher_.join();
+    }
+    this->flush();
+    REDIS_EXTENDED_LOG(this->logger_, INFO, "Destroyed RedisWriteCoalescer for thread ID: " + std::to_string(static_cast<int>(this->threadId_)));
+}
+
+void RedisWriteCoalescer::write(const std::string& key, const std::string& value) {
+    this->writes_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(this->pendingMutex_);
+    auto result = this->pending_.emplace(key, value);
+    if (!result.second) {
+        // Reuse the buffer of the value being replaced
+        result.first->second.assign(value);
+        this->coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool RedisWriteCoalescer::flush() {
+    std::lock_guard<std::mutex> flushLock(this->flushMutex_);
+    std::unordered_map<std::string, std::string> taken;
+    FlushCallback callback;
+    int replicas;
+    std::chrono::milliseconds replicaTimeout;
+    {
+        std::lock_guard<std::mutex> lock(this->pendingMutex_);
+        taken.swap(this->pending_);
+        callback = this->callback_;
+        replicas = this->replicas_;
+        replicaTimeout = this->replicaTimeout_;
+    }
+    if (taken.empty()) {
+        return true;
+    }
+
+    bool success = true;
+    std::vector<std::pair<std::string, std::string>> batch;
+    batch.reserve(std::min(this->batchSize_, taken.size()));
+    auto it = taken.begin();
+    while (it != taken.end()) {
+        batch.clear();
+        for (; it != taken.end() && batch.size() < this->batchSize_; ++it) {
+            batch.emplace_back(it->first, std::move(it->second));
+        }
+        bool sent = this->sendBatch(batch, replicas, replicaTimeout);
+        success = success && sent;
+        if (callback) {
+            std::vector<std::string> keys;
+            keys.reserve(batch.size());
+            for (const auto& entry : batch) {
+                keys.push_back(entry.first);
+            }
+            callback(keys, sent);
+        }
+    }
+    REDIS_EXTENDED_LOG(this->logger_, DEBUG, "Flushed " + std::to_string(taken.size()) + " coalesced keys");
+    return success;
+}
+
+void RedisWriteCoalescer::setFlushCallback(FlushCallback callback) {
+    std::lock_guard<std::mutex> lock(this->pendingMutex_);
+    this->callback_ = std::move(callback);
+}
+
+void RedisWriteCoalescer::setReplicaAck(int replicas, std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(this->pendingMutex_);
+    this->replicas_ = replicas > 0 ? replicas : 0;
+    this->replicaTimeout_ = timeout;
+}
+
+size_t RedisWriteCoalescer::pending() const {
+    std::lock_guard<std::mutex> lock(this->pendingMutex_);
+    return this->pending_.size();
+}
+
+RedisWriteCoalescer::Stats RedisWriteCoalescer::stats() const {
+    Stats stats;
+    stats.writes = this->writes_.load();
+    stats.coalesced = this->coalesced_.load();
+    stats.flushedKeys = this->flushedKeys_.load();
+    stats.batches = this->batches_.load();
+    stats.failures = this->failures_.load();
+    return stats;
+}
+
+void RedisWriteCoalescer::setTraceRecorder(TraceRecorder* recorder) {
+    this->tracer_ = recorder;
+}
+
+bool RedisWriteCoalescer::sendBatch(const std::vector<std::pair<std::string, std::string>>& batch, int replicas,
+                                    std::chrono::milliseconds replicaTimeout) {
+    try {
+        auto pipe = this->redis_.pipeline(false);
+        for (const auto& entry : batch) {
+            pipe.set(entry.first, entry.second);
+        }
+        if (replicas > 0) {
+            pipe.command("WAIT", std::to_string(replicas), std::to_string(replicaTimeout.count()));
+        }
+        auto replies = pipe.exec();
+        this->batches_.fetch_add(1, std::memory_order_relaxed);
+        this->flushedKeys_.fetch_add(batch.size(), std::memory_order_relaxed);
+        for (const auto& entry : batch) {
+            this->trace(benchmark::TraceOp::WRITE, entry.first, entry.second.size());
+        }
+        if (replicas > 0) {
+            long long acknowledged = replies.get<long long>(batch.size());
+            if (acknowledged < replicas) {
+                this->failures_.fetch_add(1, std::memory_order_relaxed);
+                REDIS_EXTENDED_LOG(this->logger_, WARNING, "Batch of " + std::to_string(batch.size()) + " keys acknowledged by "
+                    + std::to_string(acknowledged) + " of " + std::to_string(replicas) + " replicas");
+                return false;
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        this->failures_.fetch_add(1, std::memory_order_relaxed);
+        REDIS_EXTENDED_LOG(this->logger_, ERROR, "Error flushing " + std::to_string(batch.size()) + " keys: " + e.what());
+        // Keep the values for the next flush unless they have been superseded
+        std::lock_guard<std::mutex> lock(this->pendingMutex_);
+        for (const auto& entry : batch) {
+            this->pending_.emplace(entry.first, entry.second);
+        }
+        return false;
+    }
+}
+
+void RedisWriteCoalescer::run() {
+    while (this->running_) {
+        {
+            std::unique_lock<std::mutex> lock(this->pendingMutex_);
+            this->wakeCv_.wait_for(lock, this->window_, [this]() { return !this->running_; });
+        }
+        if (this->running_) {
+            this->flush();
+        }
+    }
+}
+
+void RedisWriteCoalescer::trace(benchmark::TraceOp op, const std::string& key, size_t valueSize) const {
+    if (this->tracer_) {
+        this->tracer_->record(op, key, valueSize);
+    }
+}
+
+} // namespace redis_extended
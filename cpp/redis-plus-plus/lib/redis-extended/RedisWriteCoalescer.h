@@ -0,0 +1,122 @@
+#ifndef REDIS_EXTENDED_WRITE_COALESCER_H
+#define REDIS_EXTENDED_WRITE_COALESCER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sw/redis++/redis++.h>
+#include "Logging.h"
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+} // namespace benchmark
+
+namespace redis_extended {
+
+class TraceRecorder;
+
+// Write-behind buffer for keys that are overwritten far more often than anyone reads them.
+// write() only records the value; repeated writes to a key within one window collapse into the
+// latest value. A background thread swaps the pending set out every window and sends it as
+// pipelined SETs, batchSize keys per round trip. Writes are therefore acknowledged before they
+// reach Redis: a crash loses up to one window, and readers see values up to one window old.
+// Flushed SETs take no lease and bump no version counter, so they are invisible to
+// RedisKeyManager::compareAndSet() and can be overwritten by it.
+//
+// Durability hooks:
+//   - flush() blocks until every write accepted before the call has been sent
+//   - setFlushCallback() reports each batch's keys and outcome after it is sent
+//   - setReplicaAck() appends WAIT to every batch; the batch only counts as successful once the
+//     requested number of replicas acknowledged it
+// Keys of a batch that could not be sent are queued again unless a newer value arrived
+// meanwhile; a missed replica acknowledgement is reported but not retried, since the primary
+// already holds the values. Callbacks run on the flushing thread.
+class RedisWriteCoalescer {
+public:
+    // Called after each batch with the keys it carried and whether it was stored (and replicated)
+    using FlushCallback = std::function<void(const std::vector<std::string>& keys, bool success)>;
+
+    // Counters since construction
+    struct Stats {
+        uint64_t writes = 0;      // write() calls
+        uint64_t coalesced = 0;   // Writes replaced by a later value before being sent
+        uint64_t flushedKeys = 0; // Keys stored by successful batches
+        uint64_t batches = 0;     // Pipelines sent
+        uint64_t failures = 0;    // Batches that failed or missed the replica acknowledgement
+    };
+
+    // Constructor; starts the flush thread
+    RedisWriteCoalescer(sw::redis::Redis& redis,
+                        std::chrono::milliseconds window = std::chrono::milliseconds(10),
+                        size_t batchSize = 100, uint8_t threadId = 0,
+                        logging::ILogger* logger = nullptr);
+
+    // Destructor; stops the flush thread and sends whatever is still pending
+    ~RedisWriteCoalescer();
+
+    RedisWriteCoalescer(const RedisWriteCoalescer&) = delete;
+    RedisWriteCoalescer& operator=(const RedisWriteCoalescer&) = delete;
+
+    // Buffer a value for key; the latest value within a window wins
+    void write(const std::string& key, const std::string& value);
+
+    // Send everything pending now; true if every batch succeeded
+    bool flush();
+
+    // Durability hooks
+    void setFlushCallback(FlushCallback callback);
+    void setReplicaAck(int replicas, std::chrono::milliseconds timeout);
+
+    // Number of keys waiting for the next flush
+    size_t pending() const;
+
+    Stats stats() const;
+
+    // Capture every key sent by this coalescer (nullptr disables tracing)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+private:
+    sw::redis::Redis& redis_;          // Reference to Redis connection
+    std::chrono::milliseconds window_; // Coalescing window
+    size_t batchSize_;                 // Keys per pipeline
+    uint8_t threadId_;                 // Thread ID for logging purposes
+    logging::ILogger* logger_;         // Logger instance for tracking operations
+    TraceRecorder* tracer_;            // Optional workload trace recorder
+
+    mutable std::mutex pendingMutex_;  // Guards pending_, callback_ and the replica settings
+    std::unordered_map<std::string, std::string> pending_; // Latest value per key
+    FlushCallback callback_;
+    int replicas_;                     // Replicas WAIT asks for, 0 disables
+    std::chrono::milliseconds replicaTimeout_;
+
+    std::mutex flushMutex_;            // Serialises flushes so flush() waits for one in progress
+    std::atomic<bool> running_;        // Flush thread keeps going while set
+    std::condition_variable wakeCv_;   // Cuts the window short on shutdown
+    std::thread flusher_;
+
+    std::atomic<uint64_t> writes_;
+    std::atomic<uint64_t> coalesced_;
+    std::atomic<uint64_t> flushedKeys_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> failures_;
+
+    // Send one batch, requeueing it if the pipeline fails; returns whether it was stored and acknowledged
+    bool sendBatch(const std::vector<std::pair<std::string, std::string>>& batch, int replicas,
+                   std::chrono::milliseconds replicaTimeout);
+
+    // Flush thread body
+    void run();
+
+    // Helper function to record an operation on one key when tracing is enabled
+    void trace(benchmark::TraceOp op, const std::string& key, size_t valueSize = 0) const;
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_WRITE_COALESCER_H
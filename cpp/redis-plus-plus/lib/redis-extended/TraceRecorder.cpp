@@ -0,0 +1,36 @@
+#include "TraceRecorder.h"
+#include <Trace.h>
+
+namespace redis_extended {
+
+TraceRecorder::TraceRecorder(const std::string& path)
+    : writer_(new benchmark::TraceWriter(path)), start_(std::chrono::steady_clock::now()) {
+}
+
+TraceRecorder::~TraceRecorder() {
+    this->flush();
+}
+
+bool TraceRecorder::isOpen() const {
+    return this->writer_->isOpen();
+}
+
+void TraceRecorder::record(benchmark::TraceOp op, const std::string& key, size_t valueSize) {
+    // Timestamp under the lock so records from concurrent threads stay in order
+    std::lock_guard<std::mutex> guard(this->mutex_);
+    auto elapsed = std::chrono::steady_clock::now() - this->start_;
+    uint64_t timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    this->writer_->write(benchmark::TraceRecord{op, timestamp, key, static_cast<uint32_t>(valueSize)});
+}
+
+void TraceRecorder::flush() {
+    std::lock_guard<std::mutex> guard(this->mutex_);
+    this->writer_->flush();
+}
+
+size_t TraceRecorder::recordCount() const {
+    std::lock_guard<std::mutex> guard(this->mutex_);
+    return this->writer_->recordCount();
+}
+
+} // namespace redis_extended
@@ -0,0 +1,48 @@
+#ifndef REDIS_EXTENDED_TRACE_RECORDER_H
+#define REDIS_EXTENDED_TRACE_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace benchmark {
+enum class TraceOp : uint8_t;
+class TraceWriter;
+} // namespace benchmark
+
+namespace redis_extended {
+
+// Captures the operations issued through RedisKeyManager and RedisChannelManager into a
+// compact binary trace that the benchmark library's TraceReplayer can replay.
+// A single recorder may be shared by managers running on different threads.
+class TraceRecorder {
+public:
+    // Constructor; the trace file is truncated and the capture clock starts here
+    explicit TraceRecorder(const std::string& path);
+
+    // Destructor; flushes pending records
+    ~TraceRecorder();
+
+    // Check whether the trace file could be opened
+    bool isOpen() const;
+
+    // Record one operation on a key or channel with the size of its payload
+    void record(benchmark::TraceOp op, const std::string& key, size_t valueSize = 0);
+
+    // Flush buffered records to disk
+    void flush();
+
+    // Number of records captured so far
+    size_t recordCount() const;
+
+private:
+    std::unique_ptr<benchmark::TraceWriter> writer_;   // Binary trace writer, kept out of the installed header
+    std::chrono::steady_clock::time_point start_;      // Capture start, origin of record timestamps
+    mutable std::mutex mutex_;                         // Serialises writers from different threads
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_TRACE_RECORDER_H
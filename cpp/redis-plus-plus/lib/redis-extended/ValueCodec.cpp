@@ -0,0 +1,201 @@
+#include "ValueCodec.h"
+#include <cstring>
+#include <limits>
+#ifdef REDIS_EXTENDED_LZ4
+#include <lz4.h>
+#endif
+
+namespace redis_extended {
+
+namespace {
+
+const char MAGIC[4] = {'\0', 'R', 'X', 'C'};
+
+void putSize(char* out, uint32_t size) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<char>((size >> (8 * i)) & 0xff);
+    }
+}
+
+uint32_t getSize(const char* in) {
+    uint32_t size = 0;
+    for (int i = 0; i < 4; ++i) {
+        size |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return size;
+}
+
+std::chrono::nanoseconds since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+} // namespace
+
+double ValueCodec::Stats::ratio() const {
+    return this->encodedBytes > 0 ? static_cast<double>(this->rawBytes) / this->encodedBytes : 1.0;
+}
+
+ValueCodec::ValueCodec(Codec codec, size_t threshold)
+    : codec_(available(codec) ? codec : Codec::NONE), threshold_(threshold) {
+}
+
+std::string ValueCodec::encode(const std::string& value) const {
+    Counters& counters = this->counters_[static_cast<size_t>(this->codec_)];
+    bool compressible = this->codec_ != Codec::NONE && value.size() >= this->threshold_
+        && value.size() <= std::numeric_limits<uint32_t>::max();
+    if (compressible) {
+        auto start = std::chrono::steady_clock::now();
+        std::string encoded;
+#ifdef REDIS_EXTENDED_LZ4
+        if (this->codec_ == Codec::LZ4) {
+            int bound = LZ4_compressBound(static_cast<int>(value.size()));
+            encoded.resize(HEADER_SIZE + bound);
+            int written = bound > 0 ? LZ4_compress_default(value.data(), &encoded[HEADER_SIZE],
+                                                           static_cast<int>(value.size()), bound) : 0;
+            encoded.resize(written > 0 ? HEADER_SIZE + written : 0);
+        }
+#endif
+        counters.encodeNanos.fetch_add(since(start).count(), std::memory_order_relaxed);
+        if (!encoded.empty() && encoded.size() < value.size()) {
+            std::memcpy(&encoded[0], MAGIC, sizeof(MAGIC));
+            encoded[4] = static_cast<char>(this->codec_);
+            putSize(&encoded[5], static_cast<uint32_t>(value.size()));
+            counters.encoded.fetch_add(1, std::memory_order_relaxed);
+            counters.rawBytes.fetch_add(value.size(), std::memory_order_relaxed);
+            counters.encodedBytes.fetch_add(encoded.size(), std::memory_order_relaxed);
+            return encoded;
+        }
+    }
+    counters.skipped.fetch_add(1, std::memory_order_relaxed);
+    if (isFramed(value.data(), value.size())) {
+        // Escape a plain value that would otherwise be mistaken for a frame
+        return frame(Codec::NONE, value.size(), value.data(), value.size());
+    }
+    return value;
+}
+
+bool ValueCodec::decode(const char* data, size_t size, std::string& out) const {
+    if (!isFramed(data, size)) {
+        out.assign(data, size);
+        return true;
+    }
+    if (size < HEADER_SIZE) {
+        return false;
+    }
+    uint8_t id = static_cast<uint8_t>(data[4]);
+    uint32_t originalSize = getSize(data + 5);
+    const char* payload = data + HEADER_SIZE;
+    size_t payloadSize = size - HEADER_SIZE;
+    if (id >= CODEC_COUNT) {
+        return false;
+    }
+    Counters& counters = this->counters_[id];
+    switch (static_cast<Codec>(id)) {
+        case Codec::NONE:
+            if (payloadSize != originalSize) {
+                return false;
+            }
+            out.assign(payload, payloadSize);
+            counters.decoded.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        case Codec::LZ4: {
+#ifdef REDIS_EXTENDED_LZ4
+            // The size comes from an untrusted header: LZ4 expands at most ~255:1, so anything
+            // larger is corrupt and must not drive the allocation
+            if (payloadSize > static_cast<size_t>(LZ4_MAX_INPUT_SIZE) || originalSize > static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE)
+                || originalSize > static_cast<uint64_t>(payloadSize) * 255) {
+                return false;
+            }
+            auto start = std::chrono::steady_clock::now();
+            out.resize(originalSize);
+            int written = LZ4_decompress_safe(payload, out.empty() ? nullptr : &out[0],
+                                              static_cast<int>(payloadSize), static_cast<int>(originalSize));
+            counters.decodeNanos.fetch_add(since(start).count(), std::memory_order_relaxed);
+            if (written < 0 || static_cast<uint32_t>(written) != originalSize) {
+                return false;
+            }
+            counters.decoded.fetch_add(1, std::memory_order_relaxed);
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+    return false;
+}
+
+bool ValueCodec::decode(const std::string& data, std::string& out) const {
+    return this->decode(data.data(), data.size(), out);
+}
+
+ValueCodec::Codec ValueCodec::codec() const {
+    return this->codec_;
+}
+
+size_t ValueCodec::threshold() const {
+    return this->threshold_;
+}
+
+ValueCodec::Stats ValueCodec::stats(Codec codec) const {
+    const Counters& counters = this->counters_[static_cast<size_t>(codec)];
+    Stats stats;
+    stats.encoded = counters.encoded.load(std::memory_order_relaxed);
+    stats.skipped = counters.skipped.load(std::memory_order_relaxed);
+    stats.decoded = counters.decoded.load(std::memory_order_relaxed);
+    stats.rawBytes = counters.rawBytes.load(std::memory_order_relaxed);
+    stats.encodedBytes = counters.encodedBytes.load(std::memory_order_relaxed);
+    stats.encodeTime = std::chrono::nanoseconds(counters.encodeNanos.load(std::memory_order_relaxed));
+    stats.decodeTime = std::chrono::nanoseconds(counters.decodeNanos.load(std::memory_order_relaxed));
+    return stats;
+}
+
+void ValueCodec::reset() {
+    for (Counters& counters : this->counters_) {
+        counters.encoded = 0;
+        counters.skipped = 0;
+        counters.decoded = 0;
+        counters.rawBytes = 0;
+        counters.encodedBytes = 0;
+        counters.encodeNanos = 0;
+        counters.decodeNanos = 0;
+    }
+}
+
+bool ValueCodec::isFramed(const char* data, size_t size) {
+    return size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool ValueCodec::available(Codec codec) {
+    switch (codec) {
+        case Codec::NONE:
+            return true;
+        case Codec::LZ4:
+#ifdef REDIS_EXTENDED_LZ4
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* ValueCodec::codecName(Codec codec) {
+    switch (codec) {
+        case Codec::NONE: return "none";
+        case Codec::LZ4: return "lz4";
+    }
+    return "unknown";
+}
+
+std::string ValueCodec::frame(Codec codec, size_t originalSize, const char* payload, size_t payloadSize) {
+    std::string framed(HEADER_SIZE + payloadSize, '\0');
+    std::memcpy(&framed[0], MAGIC, sizeof(MAGIC));
+    framed[4] = static_cast<char>(codec);
+    putSize(&framed[5], static_cast<uint32_t>(originalSize));
+    if (payloadSize > 0) {
+        std::memcpy(&framed[HEADER_SIZE], payload, payloadSize);
+    }
+    return framed;
+}
+
+} // namespace redis_extended
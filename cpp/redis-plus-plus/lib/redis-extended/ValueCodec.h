@@ -0,0 +1,101 @@
+#ifndef REDIS_EXTENDED_VALUE_CODEC_H
+#define REDIS_EXTENDED_VALUE_CODEC_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace redis_extended {
+
+// Optional compression of values and pub/sub payloads. Values of at least `threshold` bytes are
+// compressed and stored behind a small frame:
+//
+//   "\0RXC" | codec id (1 byte) | original size (4 bytes, little endian) | payload
+//
+// Anything else is stored as is, so compressed and plain values coexist under the same keys and
+// channels and a reader with a codec understands data written without one. A plain value that
+// happens to start with the magic is framed with Codec::NONE to keep decoding unambiguous, and a
+// value that does not shrink is stored plain. One instance may be shared by any number of
+// managers and threads.
+//
+// LZ4 is available when the library is built with it (REDIS_EXTENDED_LZ4, set by CMake when
+// liblz4 is found); otherwise a codec asking for it falls back to Codec::NONE, and LZ4 frames
+// written elsewhere cannot be decoded.
+class ValueCodec {
+public:
+    // Compression algorithm; the value is the id written in the frame
+    enum class Codec : uint8_t {
+        NONE = 0, // Framed but not compressed
+        LZ4 = 1
+    };
+    static constexpr size_t CODEC_COUNT = 2;
+    static constexpr size_t HEADER_SIZE = 9;
+
+    // Counters of one codec since construction (or reset())
+    struct Stats {
+        uint64_t encoded = 0;      // Values written compressed
+        uint64_t skipped = 0;      // Values written plain: below the threshold or incompressible
+        uint64_t decoded = 0;      // Frames decoded
+        uint64_t rawBytes = 0;     // Size of the encoded values before compression
+        uint64_t encodedBytes = 0; // Size of the same values as written, header included
+        std::chrono::nanoseconds encodeTime{0}; // CPU time spent compressing, skipped values included
+        std::chrono::nanoseconds decodeTime{0}; // CPU time spent decompressing
+
+        // rawBytes / encodedBytes, or 1 when nothing was compressed
+        double ratio() const;
+    };
+
+    // Constructor; an unavailable codec degrades to Codec::NONE
+    explicit ValueCodec(Codec codec = Codec::LZ4, size_t threshold = 1024);
+
+    ValueCodec(const ValueCodec&) = delete;
+    ValueCodec& operator=(const ValueCodec&) = delete;
+
+    // Value as it should be written
+    std::string encode(const std::string& value) const;
+
+    // Value as it was before encode(); plain input is copied through. Returns false on a frame
+    // that is truncated, corrupt or uses a codec this build cannot decode (out is unspecified).
+    bool decode(const char* data, size_t size, std::string& out) const;
+    bool decode(const std::string& data, std::string& out) const;
+
+    // Codec used by encode()
+    Codec codec() const;
+    size_t threshold() const;
+
+    Stats stats(Codec codec) const;
+    void reset();
+
+    // Whether data starts with a codec frame
+    static bool isFramed(const char* data, size_t size);
+
+    // Whether this build can compress and decompress with codec
+    static bool available(Codec codec);
+
+    // Label used in reports, e.g. "lz4"
+    static const char* codecName(Codec codec);
+
+private:
+    // Lock-free counters behind Stats
+    struct Counters {
+        std::atomic<uint64_t> encoded{0};
+        std::atomic<uint64_t> skipped{0};
+        std::atomic<uint64_t> decoded{0};
+        std::atomic<uint64_t> rawBytes{0};
+        std::atomic<uint64_t> encodedBytes{0};
+        std::atomic<int64_t> encodeNanos{0};
+        std::atomic<int64_t> decodeNanos{0};
+    };
+
+    Codec codec_;       // Codec used by encode()
+    size_t threshold_;  // Smallest value encode() compresses
+    mutable Counters counters_[CODEC_COUNT];
+
+    // Header for codec and originalSize followed by payload
+    static std::string frame(Codec codec, size_t originalSize, const char* payload, size_t payloadSize);
+};
+
+} // namespace redis_extended
+
+#endif // REDIS_EXTENDED_VALUE_CODEC_H
@@ -2,12 +2,11 @@
 #include <thread>
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include "pubsub_routines.h"
 #include "Logging.h"
-
-// Macro for logging
-#define LOG_MSG(level, thread_id, message) \
-    std::cout << "[" << level << "] Thread " << static_cast<int>(thread_id) << ": " << message << std::endl
+#include "AsyncLogger.h"
+#include "RedisConnectionFactory.h"
 
 // Macro for delay configuration (in milliseconds)
 #define DELAY 10
@@ -23,8 +22,16 @@ int main() {
     opts.port = std::stoi(redis_port);
     opts.socket_timeout = std::chrono::seconds(5); // Set timeout to 5 seconds
     
-    redis_extended::logging::DefaultLogger logger;
-    LOG_MSG("INFO", 0, "Threads will connect to Redis at " + opts.host + 
+    // One asynchronous logger shared by every thread; records are written in batches off the hot path
+    redis_extended::logging::AsyncLogger logger;
+
+    // Shared connection pools; every thread draws from the same warmed pool per endpoint
+    redis_extended::RedisConnectionFactory::PoolSettings pool_settings;
+    pool_settings.size = 4;
+    pool_settings.warmConnections = 4;
+    redis_extended::RedisConnectionFactory factory(pool_settings, &logger);
+
+    LOG_MSG(&logger, INFO, 0, "Threads will connect to Redis at " + opts.host + 
         ":" + std::to_string(opts.port) + " with timeout " + 
         std::to_string(opts.socket_timeout.count()) + "ms");
 
@@ -42,18 +49,18 @@ int main() {
     // Counter for unique thread IDs
     uint8_t thread_id = 0;
 
-    // Create publisher threads, each with its own Redis connection
+    // Create publisher threads, sharing the factory's pool
     for (int i = 0; i < num_publishers; ++i) {
-        std::thread pub_thread(publisher_thread, thread_id++, opts, shared_channel);
+        std::thread pub_thread(publisher_thread, thread_id++, std::ref(factory), opts, shared_channel, &logger);
         threads.push_back(std::move(pub_thread));
-        LOG_MSG("INFO", 0, "Started publisher thread with ID: " + std::to_string(static_cast<int>(thread_id - 1)));
+        LOG_MSG(&logger, INFO, 0, "Started publisher thread with ID: " + std::to_string(static_cast<int>(thread_id - 1)));
     }
 
-    // Create subscriber threads, each with its own Redis connection
+    // Create subscriber threads, sharing the factory's pool
     for (int i = 0; i < num_subscribers; ++i) {
-        std::thread sub_thread(subscriber_thread, thread_id++, opts, shared_channel);
+        std::thread sub_thread(subscriber_thread, thread_id++, std::ref(factory), opts, shared_channel, &logger);
         threads.push_back(std::move(sub_thread));
-        LOG_MSG("INFO", 0, "Started subscriber thread with ID: " + std::to_string(static_cast<int>(thread_id - 1)));
+        LOG_MSG(&logger, INFO, 0, "Started subscriber thread with ID: " + std::to_string(static_cast<int>(thread_id - 1)));
     }
 
     // Wait for all threads to complete
@@ -63,7 +70,11 @@ int main() {
         }
     }
 
-    LOG_MSG("INFO", 0, "All threads completed. Pub/Sub proof of concept simulation finished.");
+    redis_extended::RedisConnectionFactory::PoolMetrics metrics = factory.sample(opts);
+    LOG_MSG(&logger, INFO, 0, "Pool " + metrics.endpoint + ": " + std::to_string(metrics.warmed) + " warmed, mean checkout wait "
+        + std::to_string(metrics.meanWait.count()) + "us, " + std::to_string(metrics.connectedClients) + " clients connected");
+
+    LOG_MSG(&logger, INFO, 0, "All threads completed. Pub/Sub proof of concept simulation finished.");
 
     return 0;
 }
@@ -1,25 +1,21 @@
 #include <sw/redis++/redis++.h>
-#include <iostream>
 #include <chrono>
+#include <memory>
 #include <thread>
 #include <nlohmann/json.hpp>
 #include "pubsub_routines.h"
 #include "RedisChannelManager.h"
-#include "Logging.h"
-
-// Macro for logging
-#define LOG_MSG(level, thread_id, message) \
-    std::cout << "[" << level << "] Thread " << static_cast<int>(thread_id) << ": " << message << std::endl
 
 // Macro for delay configuration (in milliseconds)
 #define DELAY 100
 
 // Publisher thread function
-void publisher_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, const std::string& channel) {
-    // Create a unique Redis connection for this thread using provided options
-    sw::redis::Redis redis(opts);
-    redis_extended::RedisChannelManager channel_manager(redis, thread_id, new redis_extended::logging::DefaultLogger());
-    LOG_MSG("INFO", thread_id, "PUBLISHER: Connected to Redis");
+void publisher_thread(uint8_t thread_id, redis_extended::RedisConnectionFactory& factory,
+                      sw::redis::ConnectionOptions opts, const std::string& channel,
+                      redis_extended::logging::ILogger* logger) {
+    // Bind to the endpoint's shared, pre-connected pool
+    std::unique_ptr<redis_extended::RedisChannelManager> channel_manager = factory.channelManager(opts, thread_id);
+    LOG_MSG(logger, INFO, thread_id, "PUBLISHER: Connected to Redis");
 
     // Fixed delay for deterministic behavior
     const std::chrono::milliseconds delay(DELAY);
@@ -37,10 +33,11 @@ void publisher_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, cons
         std::string json_str = message.dump();
 
         // Publish the message
-        if (channel_manager.publish(channel, json_str)) {
-            LOG_MSG("INFO", thread_id, "PUBLISHER: Published JSON message to " + channel + ": " + json_str);
+        if (channel_manager->publish(channel, json_str)) {
+            // Per-message record at DEBUG: skipped, string building included, at the default level
+            LOG_MSG(logger, DEBUG, thread_id, "PUBLISHER: Published JSON message to " + channel + ": " + json_str);
         } else {
-            LOG_MSG("ERROR", thread_id, "PUBLISHER: Failed to publish JSON message to " + channel);
+            LOG_MSG(logger, ERROR, thread_id, "PUBLISHER: Failed to publish JSON message to " + channel);
         }
 
         // Wait before next publish attempt
@@ -49,32 +46,31 @@ void publisher_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, cons
 }
 
 // Subscriber thread function
-void subscriber_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, const std::string& channel) {
-    // Create a unique Redis connection for this thread using provided options
-    sw::redis::Redis redis(opts);
-    redis_extended::RedisChannelManager channel_manager(redis, thread_id, new redis_extended::logging::DefaultLogger());
-    LOG_MSG("INFO", thread_id, "SUBSCRIBER: Connected to Redis");
+void subscriber_thread(uint8_t thread_id, redis_extended::RedisConnectionFactory& factory,
+                       sw::redis::ConnectionOptions opts, const std::string& channel,
+                       redis_extended::logging::ILogger* logger) {
+    // Bind to the endpoint's shared, pre-connected pool
+    std::unique_ptr<redis_extended::RedisChannelManager> channel_manager = factory.channelManager(opts, thread_id);
+    LOG_MSG(logger, INFO, thread_id, "SUBSCRIBER: Connected to Redis");
 
     // Define callback for processing incoming messages
-    auto callback = [thread_id](const std::string& msg) {
+    auto callback = [thread_id, logger](const std::string& msg) {
         try {
             // Parse JSON message
             auto json_msg = nlohmann::json::parse(msg);
-            std::string log_msg = "SUBSCRIBER: Received JSON message: " + msg;
-            LOG_MSG("INFO", thread_id, log_msg);
-            std::cout << "Thread " << static_cast<int>(thread_id) << " received: " << msg << std::endl;
+            LOG_MSG(logger, DEBUG, thread_id, "SUBSCRIBER: Received JSON message: " + msg);
         } catch (const std::exception& e) {
-            LOG_MSG("ERROR", thread_id, "SUBSCRIBER: Failed to parse JSON message: " + std::string(e.what()));
+            LOG_MSG(logger, ERROR, thread_id, "SUBSCRIBER: Failed to parse JSON message: " + std::string(e.what()));
         }
     };
 
     // Subscribe to the channel
-    channel_manager.subscribe(channel, callback);
+    channel_manager->subscribe(channel, callback);
 
     // Keep the thread alive for a while to receive messages
     std::this_thread::sleep_for(std::chrono::seconds(5));
 
     // Stop subscriptions
-    channel_manager.stopSubscriptions();
-    LOG_MSG("INFO", thread_id, "SUBSCRIBER: Stopped subscription to " + channel);
+    channel_manager->stopSubscriptions();
+    LOG_MSG(logger, INFO, thread_id, "SUBSCRIBER: Stopped subscription to " + channel);
 }
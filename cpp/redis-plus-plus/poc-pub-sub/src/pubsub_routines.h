@@ -4,9 +4,19 @@
 #include <string>
 #include <cstdint>
 #include <sw/redis++/redis++.h>
+#include "Logging.h"
+#include "RedisConnectionFactory.h"
+
+// Macro for logging through the shared logger; the message is only built when the level is enabled
+#define LOG_MSG(logger, level, thread_id, message) \
+    REDIS_EXTENDED_LOG(logger, level, "Thread " + std::to_string(static_cast<int>(thread_id)) + ": " + (message))
 
 // Function prototypes for thread operations
-void publisher_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, const std::string& channel);
-void subscriber_thread(uint8_t thread_id, sw::redis::ConnectionOptions opts, const std::string& channel);
+void publisher_thread(uint8_t thread_id, redis_extended::RedisConnectionFactory& factory,
+                      sw::redis::ConnectionOptions opts, const std::string& channel,
+                      redis_extended::logging::ILogger* logger);
+void subscriber_thread(uint8_t thread_id, redis_extended::RedisConnectionFactory& factory,
+                       sw::redis::ConnectionOptions opts, const std::string& channel,
+                       redis_extended::logging::ILogger* logger);
 
 #endif // PUBSUB_ROUTINES_H
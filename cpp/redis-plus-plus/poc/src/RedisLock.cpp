@@ -1,8 +1,26 @@
 #include "RedisLock.h"
+#include <algorithm>
 #include <iostream>
+#include <random>
+#include <thread>
+
+namespace {
+
+// Delete the lock and push a single wake-up token, trimmed so idle locks keep at most one
+const char* const RELEASE_SCRIPT =
+    "redis.call('del', KEYS[1]) "
+    "redis.call('rpush', KEYS[2], '1') "
+    "redis.call('ltrim', KEYS[2], 0, 0) "
+    "return 1";
+
+// Backoff between failed waits
+const std::chrono::milliseconds MIN_BACKOFF(1);
+const std::chrono::milliseconds MAX_BACKOFF(500);
+
+} // namespace
 
 RedisLock::RedisLock(sw::redis::Redis& redis, const std::string& sharedKey, uint8_t threadId)
-    : redis_(redis), lockKey_("lock:" + sharedKey), threadId_(threadId) {
+    : redis_(redis), lockKey_("lock:" + sharedKey), wakeKey_("lock:" + sharedKey + ":wake"), threadId_(threadId) {
 }
 
 bool RedisLock::tryLock() {
@@ -22,9 +40,33 @@ bool RedisLock::tryLock() {
     }
 }
 
+bool RedisLock::lock(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds backoff = MIN_BACKOFF;
+    while (!tryLock()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            logMessage("LOCK", "Timed out waiting for lock " + lockKey_);
+            return false;
+        }
+        try {
+            // A release wakes one waiter immediately; otherwise retry after a growing, jittered wait
+            std::chrono::milliseconds wait = std::min(remaining, jitter(backoff));
+            std::string seconds = std::to_string(std::max<long long>(wait.count(), 1) / 1000.0);
+            auto token = redis_.command<sw::redis::OptionalStringPair>("BLPOP", wakeKey_, seconds);
+            backoff = token ? MIN_BACKOFF : std::min(backoff * 2, MAX_BACKOFF);
+        } catch (const std::exception& e) {
+            logMessage("ERROR", "Exception while waiting for lock: " + std::string(e.what()));
+            std::this_thread::sleep_for(jitter(backoff));
+            backoff = std::min(backoff * 2, MAX_BACKOFF);
+        }
+    }
+    return true;
+}
+
 void RedisLock::unlock() {
     try {
-        redis_.del(lockKey_);
+        redis_.eval<long long>(RELEASE_SCRIPT, {lockKey_, wakeKey_}, {});
         logMessage("LOCK", "Lock released for key " + lockKey_);
     } catch (const std::exception& e) {
         logMessage("ERROR", "Exception while releasing lock: " + std::string(e.what()));
@@ -44,6 +86,27 @@ bool RedisLock::isLocked() {
     }
 }
 
+bool RedisLock::waitUntilUnlocked(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds backoff = MIN_BACKOFF;
+    while (isLocked()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::min(remaining, jitter(backoff)));
+        backoff = std::min(backoff * 2, MAX_BACKOFF);
+    }
+    return true;
+}
+
+std::chrono::milliseconds RedisLock::jitter(std::chrono::milliseconds bound) {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    long long upper = std::max<long long>(bound.count(), 1);
+    std::uniform_int_distribution<long long> distribution((upper + 1) / 2, upper);
+    return std::chrono::milliseconds(distribution(generator));
+}
+
 void RedisLock::logMessage(const std::string& operation, const std::string& message) const {
     LOG_MSG(operation, threadId_, message);
 }
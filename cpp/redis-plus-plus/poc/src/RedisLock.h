@@ -1,6 +1,7 @@
 #ifndef REDIS_LOCK_H
 #define REDIS_LOCK_H
 
+#include <chrono>
 #include <string>
 #include <cstdint>
 #include <sw/redis++/redis++.h>
@@ -14,17 +15,27 @@ public:
     // Attempt to acquire the lock using SETNX
     bool tryLock();
 
-    // Release the lock by deleting the key
+    // Block until the lock is acquired or the timeout elapses, sleeping in BLPOP on the wake-up list
+    bool lock(std::chrono::milliseconds timeout);
+
+    // Release the lock by deleting the key and leave one wake-up token for a waiter
     void unlock();
 
     // Check if the lock exists without acquiring it
     bool isLocked();
 
+    // Wait until nobody holds the lock, polling with capped exponential backoff and jitter
+    bool waitUntilUnlocked(std::chrono::milliseconds timeout);
+
 private:
     sw::redis::Redis& redis_; // Reference to Redis connection
     std::string lockKey_;     // Key used for locking
+    std::string wakeKey_;     // List receiving one token per release
     uint8_t threadId_;        // Thread ID for logging purposes
 
+    // Uniformly random duration in [bound / 2, bound]
+    static std::chrono::milliseconds jitter(std::chrono::milliseconds bound);
+
     // Helper function to log messages using the LOG_MSG macro
     void logMessage(const std::string& operation, const std::string& message) const;
 };
@@ -8,6 +8,9 @@
 // Macro for delay configuration (in nanoseconds)
 #define DELAY 10
 
+// Macro for the maximum time to wait for the lock (in milliseconds)
+#define LOCK_TIMEOUT 5000
+
 // Read operation thread function
 void poc_read(uint8_t thread_id, const std::string& connection_string, const std::string& shared_key) {
     // Create a unique Redis connection for this thread
@@ -20,10 +23,10 @@ void poc_read(uint8_t thread_id, const std::string& connection_string, const std
 
     // Simulate multiple read attempts
     for (int attempt = 0; attempt < 5; ++attempt) {
-        // Check if lock exists before reading
-        while (lock.isLocked()) {
-            LOG_MSG("READ", thread_id, "Waiting for lock to be released before reading...");
-            std::this_thread::sleep_for(delay);
+        // Wait for the lock to be released before reading, backing off between checks
+        if (!lock.waitUntilUnlocked(std::chrono::milliseconds(LOCK_TIMEOUT))) {
+            LOG_MSG("READ", thread_id, "Timed out waiting for lock to be released before reading");
+            continue;
         }
 
         // Read the value
@@ -55,10 +58,10 @@ void poc_write(uint8_t thread_id, const std::string& connection_string, const st
 
     // Simulate multiple write attempts
     for (int attempt = 0; attempt < 3; ++attempt) {
-        // Attempt to acquire lock
-        while (!lock.tryLock()) {
-            LOG_MSG("WRITE", thread_id, "Waiting to acquire lock for writing...");
-            std::this_thread::sleep_for(delay);
+        // Block until the lock is released and acquired
+        if (!lock.lock(std::chrono::milliseconds(LOCK_TIMEOUT))) {
+            LOG_MSG("WRITE", thread_id, "Timed out waiting to acquire lock for writing");
+            continue;
         }
 
         // Write a new value
@@ -90,10 +93,10 @@ void poc_update(uint8_t thread_id, const std::string& connection_string, const s
 
     // Simulate multiple update attempts
     for (int attempt = 0; attempt < 3; ++attempt) {
-        // Attempt to acquire lock
-        while (!lock.tryLock()) {
-            LOG_MSG("UPDATE", thread_id, "Waiting to acquire lock for updating...");
-            std::this_thread::sleep_for(delay);
+        // Block until the lock is released and acquired
+        if (!lock.lock(std::chrono::milliseconds(LOCK_TIMEOUT))) {
+            LOG_MSG("UPDATE", thread_id, "Timed out waiting to acquire lock for updating");
+            continue;
         }
 
         // Read current value, modify it, and write back
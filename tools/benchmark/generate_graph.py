@@ -61,6 +61,45 @@ def generate_graph(input_file):
 
     print(f"Graph saved to {output_file}")
 
+def generate_cdf(input_file):
+    """
+    Generate a latency CDF from a histogram CSV file (PROJECTNAME_hist_TESTRUN.csv).
+    Each operation is plotted as its cumulative percentage against the bucket upper bound,
+    so no raw samples need to be loaded.
+    The output graph is saved as a PNG file in the same directory as the input file.
+    """
+    try:
+        df = pd.read_csv(input_file)
+    except Exception as e:
+        print(f"Error: Failed to read {input_file}: {e}")
+        sys.exit(1)
+
+    upper_col = df.columns[2]
+    cumulative_col = df.columns[4]
+
+    plt.figure(figsize=(14, 7))
+    for operation, group in df.groupby(df.columns[0]):
+        plt.plot(group[upper_col], group[cumulative_col], label=operation)
+        print(f"Plotted CDF for operation: {operation} with {len(group)} buckets")
+
+    plt.title('Latency CDF for Redis Operations')
+    plt.ylabel('Cumulative (%)')
+    plt.xlabel(upper_col.replace('Bucket Upper', 'Latency'))
+    plt.xscale('log')  # Set x-axis to logarithmic scale
+    plt.grid(True, linestyle='--', alpha=0.7)
+    plt.legend()
+
+    output_file = os.path.splitext(input_file)[0] + '.png'
+    plt.savefig(output_file, dpi=300, bbox_inches='tight')
+    plt.close()
+
+    print(f"Graph saved to {output_file}")
+
+def is_histogram_file(input_file):
+    """Histogram exports start with an 'Operation,Bucket Lower' header."""
+    with open(input_file, 'r') as f:
+        return f.readline().startswith('Operation,Bucket Lower')
+
 def main():
     if len(sys.argv) != 2:
         print("Usage: python generate_graph.py <input_csv_file>")
@@ -71,7 +110,10 @@ def main():
         print(f"Error: Input file {input_file} does not exist.")
         sys.exit(1)
 
-    generate_graph(input_file)
+    if is_histogram_file(input_file):
+        generate_cdf(input_file)
+    else:
+        generate_graph(input_file)
 
 if __name__ == "__main__":
     main()